@@ -33,4 +33,5 @@
 #include "./effect/Effect.h"
 #include "./envelope/Envelope.h"
 #include "./filter/Filter.h"
+#include "./noise/Noise.h"
 #include "./synth/Synth.h"
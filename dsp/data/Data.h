@@ -29,7 +29,9 @@
 
 //==============================================================================
 
+#include "./EventQueue.h"
 #include "./FifoAudioBuffer.h"
+#include "./MinMaxPyramid.h"
 #include "./RingAudioBuffer.h"
 #include "./RingBufferInterface.h"
 
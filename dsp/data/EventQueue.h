@@ -0,0 +1,169 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * A lock-free queue that carries processor events, like note-ons, from
+ * the audio thread to the GUI.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace data {
+
+//==============================================================================
+/**
+ * @brief Something that happened on the audio thread that the GUI may react
+ * to.
+ */
+struct ProcessorEvent
+{
+  enum class Type
+  {
+    NoteOn, // A note or kick started
+    Reset,  // The processor was prepared or reset
+  };
+
+  Type type = Type::Reset;
+  // Samples since the processor was prepared
+  std::int64_t timestamp = 0;
+  int note = -1;
+  float velocity = 0.0f;
+};
+
+//==============================================================================
+/**
+ * @brief A fixed-capacity single producer, single consumer event queue.
+ *
+ * @details
+ * The audio thread pushes events, a GUI component drains them on its frame
+ * tick. Neither side locks, allocates or calls into the other one, so no UI
+ * work runs inside processBlock(). When the GUI falls behind and the queue is
+ * full, new events are dropped and counted instead of blocking the audio
+ * thread.
+ *
+ * @tparam Capacity The number of events the queue holds.
+ */
+template<int Capacity = 256>
+class alignas(64) EventQueue : private juce::AbstractFifo
+{
+public:
+  using Event = ProcessorEvent;
+
+  //============================================================================
+  EventQueue() noexcept
+    : AbstractFifo(Capacity + 1)
+  {
+  }
+
+  //============================================================================
+  /**
+   * @brief Adds an event. Only call this from the producing thread.
+   * @param _event The event.
+   * @return False if the queue is full and the event was dropped.
+   */
+  forcedinline bool push(const Event& _event) noexcept
+  {
+    int firstBlockStart, firstBlockSize, secondBlockStart, secondBlockSize;
+    prepareToWrite(
+      1, firstBlockStart, firstBlockSize, secondBlockStart, secondBlockSize);
+
+    if (firstBlockSize == 0) {
+      numDropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    events[static_cast<size_t>(firstBlockStart)] = _event;
+    finishedWrite(1);
+    return true;
+  }
+
+  //============================================================================
+  /**
+   * @brief Removes the oldest event. Only call this from the consuming thread.
+   * @param _event Receives the event.
+   * @return False if the queue was empty.
+   */
+  forcedinline bool pop(Event& _event) noexcept
+  {
+    int firstBlockStart, firstBlockSize, secondBlockStart, secondBlockSize;
+    prepareToRead(
+      1, firstBlockStart, firstBlockSize, secondBlockStart, secondBlockSize);
+
+    if (firstBlockSize == 0)
+      return false;
+
+    _event = events[static_cast<size_t>(firstBlockStart)];
+    finishedRead(1);
+    return true;
+  }
+
+  //============================================================================
+  /**
+   * @brief Hands all queued events to a function, oldest first.
+   * @param _function Called with each event on the consuming thread.
+   * @return The number of events.
+   */
+  template<typename Function>
+  inline int drain(Function&& _function)
+  {
+    int count = 0;
+    Event event;
+    while (pop(event)) {
+      _function(event);
+      ++count;
+    }
+    return count;
+  }
+
+  //============================================================================
+  /**
+   * @brief Gets the number of events dropped because the queue was full.
+   */
+  [[nodiscard]] inline std::uint32_t getNumDropped() const noexcept
+  {
+    return numDropped.load(std::memory_order_relaxed);
+  }
+
+  static constexpr int capacity = Capacity;
+
+private:
+  // AbstractFifo keeps one slot free to tell full from empty
+  std::array<Event, static_cast<size_t>(Capacity) + 1> events;
+  std::atomic<std::uint32_t> numDropped{ 0 };
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EventQueue)
+};
+
+} // namespace data
+} // namespace dsp
+} // namespace dmt
@@ -27,6 +27,9 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <span>
 
 //==============================================================================
 
@@ -40,6 +43,11 @@ namespace data {
  *
  * This class uses a circular buffer to manage audio data in a lock-free manner.
  *
+ * Besides copying out with readFromFifo(), the consumer can read the ready
+ * samples in place: beginRead() returns the two contiguous regions, getSpans()
+ * gives them as spans per channel, and endRead() frees them. Samples that
+ * don't fit when adding are dropped, and counted as overruns.
+ *
  * @tparam SampleType The type of audio sample (e.g., float, double).
  */
 template<typename SampleType>
@@ -49,6 +57,31 @@ class alignas(64) FifoAudioBuffer : public juce::AbstractFifo
   using ChannelData = std::vector<float>;
 
 public:
+  /**
+   * @brief The ready samples, as up to two contiguous regions of the buffer.
+   */
+  struct ReadRegions
+  {
+    int start1 = 0;
+    int size1 = 0;
+    int start2 = 0;
+    int size2 = 0;
+
+    [[nodiscard]] inline int getNumSamples() const noexcept
+    {
+      return size1 + size2;
+    }
+  };
+
+  /**
+   * @brief The ready samples of one channel, oldest first.
+   */
+  struct ChannelSpans
+  {
+    std::span<const SampleType> first;
+    std::span<const SampleType> second;
+  };
+
   //============================================================================
   /**
    * @brief Constructs a FifoAudioBuffer with the specified number of channels
@@ -81,6 +114,13 @@ public:
                    secondBlockStart,
                    secondBlockSize);
 
+    const int numDropped = numSamples - firstBlockSize - secondBlockSize;
+    if (numDropped > 0) [[unlikely]] {
+      overruns.fetch_add(1, std::memory_order_relaxed);
+      droppedSamples.fetch_add(static_cast<std::uint64_t>(numDropped),
+                               std::memory_order_relaxed);
+    }
+
     for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
       if (firstBlockSize > 0)
         buffer.copyFrom(
@@ -131,6 +171,76 @@ public:
     finishedRead(firstBlockSize + secondBlockSize);
   }
 
+  //============================================================================
+  /**
+   * @brief Starts reading the ready samples in place.
+   *
+   * @param _maxSamples The most samples to read, or -1 for all ready ones.
+   * @return The regions to pass to getSpans() and endRead().
+   *
+   * @details
+   * The writer leaves the regions alone until endRead() is called.
+   */
+  forcedinline ReadRegions beginRead(const int _maxSamples = -1) const noexcept
+  {
+    const int numReady = getNumReady();
+    const int numSamples =
+      _maxSamples < 0 ? numReady : jmin(_maxSamples, numReady);
+
+    ReadRegions regions;
+    prepareToRead(numSamples,
+                  regions.start1,
+                  regions.size1,
+                  regions.start2,
+                  regions.size2);
+    return regions;
+  }
+
+  //============================================================================
+  /**
+   * @brief Gets the samples of a channel in the regions being read.
+   *
+   * @param _regions The regions returned by beginRead().
+   * @param _channel The channel.
+   * @return The spans, which stay valid until endRead().
+   */
+  forcedinline ChannelSpans getSpans(const ReadRegions& _regions,
+                                     const int _channel) const noexcept
+  {
+    const SampleType* data = buffer.getReadPointer(_channel);
+    return { { data + _regions.start1, static_cast<size_t>(_regions.size1) },
+             { data + _regions.start2, static_cast<size_t>(_regions.size2) } };
+  }
+
+  //============================================================================
+  /**
+   * @brief Frees the regions of the last beginRead() for the writer.
+   *
+   * @param _regions The regions returned by beginRead().
+   */
+  forcedinline void endRead(const ReadRegions& _regions) noexcept
+  {
+    finishedRead(_regions.getNumSamples());
+  }
+
+  //============================================================================
+  /**
+   * @brief Gets how often addToFifo() had to drop samples.
+   */
+  [[nodiscard]] forcedinline std::uint64_t getNumOverruns() const noexcept
+  {
+    return overruns.load(std::memory_order_relaxed);
+  }
+
+  //============================================================================
+  /**
+   * @brief Gets how many samples per channel addToFifo() dropped in total.
+   */
+  [[nodiscard]] forcedinline std::uint64_t getNumDroppedSamples() const noexcept
+  {
+    return droppedSamples.load(std::memory_order_relaxed);
+  }
+
   //============================================================================
   /**
    * @brief Resizes the FIFO buffer.
@@ -191,6 +301,8 @@ public:
 
 private:
   juce::AudioBuffer<SampleType> buffer;
+  std::atomic<std::uint64_t> overruns{ 0 };
+  std::atomic<std::uint64_t> droppedSamples{ 0 };
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FifoAudioBuffer)
 };
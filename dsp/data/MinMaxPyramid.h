@@ -0,0 +1,322 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * A min/max summary of a ring buffer at several resolutions, kept up to
+ * date as samples are written.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace data {
+
+//==============================================================================
+/**
+ * @brief Min/max pyramid over the raw indices of a ring buffer.
+ *
+ * @details
+ * Level 0 holds the minimum and maximum of every 16 samples, and each level
+ * above summarizes 16 buckets of the one below, so the buckets span 16, 256
+ * and 4096 samples. After a write only the buckets the new samples fall in
+ * are reduced again, from the level below. A query over any range then
+ * combines whole buckets and only reads single samples at its edges.
+ *
+ * Buckets are addressed by raw index, so a level is only used if its bucket
+ * size divides the size of the ring. Like the samples themselves, the
+ * pyramid is written by the writer of the ring and read by its readers.
+ *
+ * @tparam SampleType The type of audio sample (e.g., float, double).
+ */
+template<typename SampleType>
+class alignas(64) MinMaxPyramid
+{
+  using AudioBuffer = juce::AudioBuffer<SampleType>;
+
+public:
+  static constexpr int numLevels = 3;
+  static constexpr int levelShift = 4;
+  static constexpr int fanOut = 1 << levelShift;
+
+  /**
+   * @brief The extremes of a range of samples.
+   */
+  struct MinMax
+  {
+    SampleType min;
+    SampleType max;
+  };
+
+  //============================================================================
+  MinMaxPyramid() = default;
+
+  //============================================================================
+  /**
+   * @brief Allocates the levels that fit a ring buffer.
+   *
+   * @param _numChannels The number of channels of the ring.
+   * @param _ringSize The number of samples of the ring.
+   */
+  inline void setSize(const int _numChannels, const int _ringSize)
+  {
+    ringSize = _ringSize;
+    numUsedLevels = 0;
+    for (int level = 0; level < numLevels; ++level) {
+      const int bucketSize = getBucketSize(level);
+      if (_ringSize < bucketSize || _ringSize % bucketSize != 0)
+        break;
+
+      const auto numBuckets = static_cast<size_t>(_ringSize / bucketSize);
+      auto& levelData = levels[static_cast<size_t>(level)];
+      levelData.mins.assign(static_cast<size_t>(_numChannels),
+                            std::vector<SampleType>(numBuckets));
+      levelData.maxs.assign(static_cast<size_t>(_numChannels),
+                            std::vector<SampleType>(numBuckets));
+      ++numUsedLevels;
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Resets all buckets to silence.
+   */
+  inline void clear() noexcept
+  {
+    for (auto& levelData : levels) {
+      for (auto& channel : levelData.mins)
+        std::fill(channel.begin(), channel.end(), SampleType(0));
+      for (auto& channel : levelData.maxs)
+        std::fill(channel.begin(), channel.end(), SampleType(0));
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Gets the number of samples a bucket of a level spans.
+   */
+  [[nodiscard]] static constexpr int getBucketSize(const int _level) noexcept
+  {
+    return fanOut << (levelShift * _level);
+  }
+
+  //============================================================================
+  /**
+   * @brief Gets the number of levels that fit the ring.
+   */
+  [[nodiscard]] inline int getNumLevels() const noexcept
+  {
+    return numUsedLevels;
+  }
+
+  //============================================================================
+  /**
+   * @brief Gets the extremes of one bucket.
+   *
+   * @param _channel The channel.
+   * @param _level The level.
+   * @param _bucket The bucket, its raw index divided by the bucket size.
+   */
+  [[nodiscard]] forcedinline MinMax getBucket(const int _channel,
+                                              const int _level,
+                                              const int _bucket) const noexcept
+  {
+    const auto& levelData = levels[static_cast<size_t>(_level)];
+    const auto channel = static_cast<size_t>(_channel);
+    const auto bucket = static_cast<size_t>(_bucket);
+    return { levelData.mins[channel][bucket], levelData.maxs[channel][bucket] };
+  }
+
+  //============================================================================
+  /**
+   * @brief Reduces the buckets that new samples fall in.
+   *
+   * @param _ring The ring buffer the samples were written to.
+   * @param _start The raw index of the first new sample.
+   * @param _numSamples The number of new samples.
+   */
+  inline void update(const AudioBuffer& _ring,
+                     const int _start,
+                     const int _numSamples) noexcept
+  {
+    if (_numSamples <= 0 || numUsedLevels == 0)
+      return;
+
+    const int numChannels = static_cast<int>(levels[0].mins.size());
+    const int last = _start + jmin(_numSamples, ringSize) - 1;
+
+    for (int level = 0; level < numUsedLevels; ++level) {
+      const int shift = levelShift * (level + 1);
+      const int numBuckets = ringSize >> shift;
+      const int firstBucket = _start >> shift;
+      const int lastBucket = last >> shift;
+
+      for (int channel = 0; channel < numChannels; ++channel) {
+        for (int bucket = firstBucket; bucket <= lastBucket; ++bucket) {
+          reduceBucket(_ring, channel, level, bucket % numBuckets);
+        }
+      }
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Gets the extremes of a range of samples.
+   *
+   * @param _ring The ring buffer the pyramid summarizes.
+   * @param _channel The channel.
+   * @param _start The raw index of the first sample.
+   * @param _numSamples The number of samples, at most the size of the ring.
+   *
+   * @details
+   * The range may run past the end of the ring and wraps around.
+   */
+  [[nodiscard]] inline MinMax getRange(const AudioBuffer& _ring,
+                                       const int _channel,
+                                       const int _start,
+                                       const int _numSamples) const noexcept
+  {
+    const SampleType* samples = _ring.getReadPointer(_channel);
+    const SampleType first = samples[_start % ringSize];
+    MinMax result{ first, first };
+
+    int position = _start;
+    const int end = _start + _numSamples;
+    while (position < end) {
+      const int index = position % ringSize;
+
+      // The coarsest bucket that starts here and fits, if any
+      int level = numUsedLevels - 1;
+      while (level >= 0 && ((index & (getBucketSize(level) - 1)) != 0 ||
+                            position + getBucketSize(level) > end)) {
+        --level;
+      }
+
+      if (level < 0) {
+        result.min = std::min(result.min, samples[index]);
+        result.max = std::max(result.max, samples[index]);
+        ++position;
+        continue;
+      }
+
+      const auto bucket = getBucket(
+        _channel, level, index >> (levelShift * (level + 1)));
+      result.min = std::min(result.min, bucket.min);
+      result.max = std::max(result.max, bucket.max);
+      position += getBucketSize(level);
+    }
+
+    return result;
+  }
+
+private:
+  //============================================================================
+  /**
+   * @brief Reduces one bucket from the samples or the level below.
+   */
+  forcedinline void reduceBucket(const AudioBuffer& _ring,
+                                 const int _channel,
+                                 const int _level,
+                                 const int _bucket) noexcept
+  {
+    const auto channel = static_cast<size_t>(_channel);
+    const auto bucket = static_cast<size_t>(_bucket);
+    auto& levelData = levels[static_cast<size_t>(_level)];
+
+    if (_level == 0) {
+      const SampleType* samples =
+        _ring.getReadPointer(_channel) + _bucket * fanOut;
+      reduce(samples,
+             samples,
+             levelData.mins[channel][bucket],
+             levelData.maxs[channel][bucket]);
+    } else {
+      const auto& below = levels[static_cast<size_t>(_level - 1)];
+      const auto offset = bucket * fanOut;
+      reduce(below.mins[channel].data() + offset,
+             below.maxs[channel].data() + offset,
+             levelData.mins[channel][bucket],
+             levelData.maxs[channel][bucket]);
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Reduces fanOut minimums and maximums to one of each.
+   *
+   * @details
+   * Runs in independent lanes that are combined at the end, so the compiler
+   * can keep the lanes in vector registers.
+   */
+  static forcedinline void reduce(const SampleType* _mins,
+                                  const SampleType* _maxs,
+                                  SampleType& _min,
+                                  SampleType& _max) noexcept
+  {
+    constexpr int numLanes = 8;
+    std::array<SampleType, numLanes> mins;
+    std::array<SampleType, numLanes> maxs;
+    for (int lane = 0; lane < numLanes; ++lane) {
+      mins[lane] = _mins[lane];
+      maxs[lane] = _maxs[lane];
+    }
+
+    for (int i = numLanes; i < fanOut; i += numLanes) {
+      for (int lane = 0; lane < numLanes; ++lane) {
+        const SampleType low = _mins[i + lane];
+        const SampleType high = _maxs[i + lane];
+        mins[lane] = low < mins[lane] ? low : mins[lane];
+        maxs[lane] = high > maxs[lane] ? high : maxs[lane];
+      }
+    }
+
+    _min = *std::min_element(mins.begin(), mins.end());
+    _max = *std::max_element(maxs.begin(), maxs.end());
+  }
+
+  //============================================================================
+  struct Level
+  {
+    std::vector<std::vector<SampleType>> mins;
+    std::vector<std::vector<SampleType>> maxs;
+  };
+
+  std::array<Level, numLevels> levels;
+  int numUsedLevels = 0;
+  int ringSize = 0;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MinMaxPyramid)
+};
+
+} // namespace data
+} // namespace dsp
+} // namespace dmt
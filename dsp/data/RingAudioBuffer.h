@@ -31,8 +31,13 @@
 //==============================================================================
 
 #include "dsp/data/FifoAudioBuffer.h"
+#include "dsp/data/MinMaxPyramid.h"
 #include "dsp/data/RingBufferInterface.h"
 #include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <span>
 
 //==============================================================================
 
@@ -45,6 +50,14 @@ namespace data {
  * @brief A ring buffer for audio data that supports efficient writing and
  * reading.
  *
+ * @details
+ * Written by a single thread and read by the readers registered through
+ * addReader(), see RingBufferInterface for how they stay in sync. Each write
+ * copies and publishes at most getGuardSize() samples, so a reader that is
+ * done before the next write never sees samples being overwritten. Every write
+ * also updates a MinMaxPyramid of the samples, for renderers that draw many
+ * samples per pixel.
+ *
  * @tparam SampleType The type of audio sample (e.g., float, double).
  */
 template<typename SampleType>
@@ -65,11 +78,14 @@ public:
    */
   constexpr RingAudioBuffer(const int _numChannelsToAllocate,
                             const int _numSamplesToAllocate) noexcept
-    : RingBufferInterface(ringBuffer, writePosition, readPositions)
-    , writePosition(0)
+    : RingBufferInterface(ringBuffer,
+                          pyramid,
+                          writeCount,
+                          readCursors,
+                          numReaders)
     , ringBuffer(_numChannelsToAllocate, _numSamplesToAllocate)
-    , readPositions(static_cast<size_t>(_numChannelsToAllocate), 0)
   {
+    pyramid.setSize(_numChannelsToAllocate, _numSamplesToAllocate);
   }
 
   //============================================================================
@@ -77,6 +93,9 @@ public:
    * @brief Writes audio data to the ring buffer.
    *
    * @param _bufferToWrite The audio buffer containing the data to write.
+   *
+   * @details
+   * Only the newest getGuardSize() samples of the buffer are written.
    */
   forcedinline void write(const AudioBuffer& _bufferToWrite) noexcept
   {
@@ -85,34 +104,24 @@ public:
     const int channelsToWrite = _bufferToWrite.getNumChannels();
     const int samplesToWrite = _bufferToWrite.getNumSamples();
 
-    if (channelsToWrite > numChannels || samplesToWrite > bufferSize)
-      [[unlikely]] {
+    if (channelsToWrite > numChannels) [[unlikely]] {
       jassertfalse;
       return;
     }
 
-    const int firstBlockSize = getNumSamples() - writePosition;
-    const int secondBlockSize = samplesToWrite - firstBlockSize;
+    const int guardSize = RingBufferInterface::getGuardSize(bufferSize);
+    const int chunkSize = jmin(guardSize, samplesToWrite);
+    const int offset = samplesToWrite - chunkSize;
+    const int writePosition = getWritePosition();
 
-    for (size_t channel = 0; channel < static_cast<size_t>(channelsToWrite);
-         ++channel) {
-      if (firstBlockSize > 0)
-        ringBuffer.copyFrom(static_cast<int>(channel),
-                            writePosition,
-                            _bufferToWrite,
-                            static_cast<int>(channel),
-                            0,
-                            firstBlockSize);
-      if (secondBlockSize > 0)
-        ringBuffer.copyFrom(static_cast<int>(channel),
-                            0,
-                            _bufferToWrite,
-                            static_cast<int>(channel),
-                            firstBlockSize,
-                            secondBlockSize);
-    }
+    for (int channel = 0; channel < channelsToWrite; ++channel)
+      writeWrapped(channel,
+                   writePosition,
+                   { _bufferToWrite.getReadPointer(channel) + offset,
+                     static_cast<size_t>(chunkSize) });
 
-    updateWritePosition(samplesToWrite);
+    pyramid.update(ringBuffer, writePosition, chunkSize);
+    updateWritePosition(chunkSize);
   }
 
   //============================================================================
@@ -120,80 +129,41 @@ public:
    * @brief Writes audio data from a FIFO buffer to the ring buffer.
    *
    * @param _bufferToWrite The FIFO buffer containing the data to write.
+   *
+   * @details
+   * Takes at most getGuardSize() samples out of the FIFO. Anything beyond
+   * stays there for the next write, e.g. after the GUI stalled.
    */
   forcedinline void write(FifoAudioBuffer& _bufferToWrite) noexcept
   {
     const int numChannels = getNumChannels();
     const int bufferSize = getNumSamples();
     const int channelsToWrite = _bufferToWrite.getNumChannels();
-    const int samplesToWrite = _bufferToWrite.getNumReady();
 
-    if (channelsToWrite > numChannels || samplesToWrite > bufferSize)
-      [[unlikely]] {
+    if (channelsToWrite > numChannels) [[unlikely]] {
       jassertfalse;
       return;
     }
 
-    const AudioBuffer& source = _bufferToWrite.getBuffer();
-    int start1, size1, start2, size2;
-    _bufferToWrite.prepareToRead(samplesToWrite, start1, size1, start2, size2);
+    // Copied straight out of the FIFO's ready regions
+    const int guardSize = RingBufferInterface::getGuardSize(bufferSize);
+    const auto regions = _bufferToWrite.beginRead(guardSize);
+    const int samplesToWrite = regions.getNumSamples();
+    if (samplesToWrite == 0)
+      return;
 
-    // Block 1 Section 1
-    if (size1 > 0) {
-      int section1size = jmin(size1, bufferSize - writePosition);
-      for (size_t channel = 0; channel < static_cast<size_t>(channelsToWrite);
-           ++channel) {
-        ringBuffer.copyFrom(static_cast<int>(channel),
-                            writePosition,
-                            source,
-                            static_cast<int>(channel),
-                            start1,
-                            section1size);
-      }
-      // Block 1 Section 2
-      int section2size = size1 - section1size;
-      if (section2size > 0) {
-        for (size_t channel = 0; channel < static_cast<size_t>(channelsToWrite);
-             ++channel) {
-          ringBuffer.copyFrom(static_cast<int>(channel),
-                              0,
-                              source,
-                              static_cast<int>(channel),
-                              start1 + section1size,
-                              section2size);
-        }
-      }
-    }
-    // Block 2 Section 3
-    if (size2 > 0) {
-      int block2start = (writePosition + size1) % bufferSize;
-      int section3size = jmin(size2, bufferSize - block2start);
-      for (size_t channel = 0; channel < static_cast<size_t>(channelsToWrite);
-           ++channel) {
-        ringBuffer.copyFrom(static_cast<int>(channel),
-                            block2start,
-                            source,
-                            static_cast<int>(channel),
-                            start2,
-                            section3size);
-      }
-      // Block 2 Section 4
-      int section4size = size2 - section3size;
-      if (section4size > 0) {
-        for (size_t channel = 0; channel < static_cast<size_t>(channelsToWrite);
-             ++channel) {
-          ringBuffer.copyFrom(static_cast<int>(channel),
-                              0,
-                              source,
-                              static_cast<int>(channel),
-                              start2 + section3size,
-                              section4size);
-        }
-      }
+    const int writePosition = getWritePosition();
+    for (int channel = 0; channel < channelsToWrite; ++channel) {
+      const auto spans = _bufferToWrite.getSpans(regions, channel);
+      writeWrapped(channel, writePosition, spans.first);
+      writeWrapped(channel,
+                   (writePosition + regions.size1) % bufferSize,
+                   spans.second);
     }
 
+    pyramid.update(ringBuffer, writePosition, samplesToWrite);
     updateWritePosition(samplesToWrite);
-    _bufferToWrite.finishedRead(size1 + size2);
+    _bufferToWrite.endRead(regions);
   }
 
   //============================================================================
@@ -207,6 +177,7 @@ public:
                            const int _numSamplesToAllocate) noexcept
   {
     ringBuffer.setSize(_numChannelsToAllocate, _numSamplesToAllocate);
+    pyramid.setSize(_numChannelsToAllocate, _numSamplesToAllocate);
   }
 
   //============================================================================
@@ -237,16 +208,27 @@ public:
    *
    * @return The write position.
    */
-  forcedinline int getWritePosition() const noexcept { return writePosition; }
+  forcedinline int getWritePosition() const noexcept
+  {
+    const auto written = writeCount.load(std::memory_order_relaxed);
+    return static_cast<int>(written % getNumSamples());
+  }
 
   //============================================================================
   /**
    * @brief Clears the ring buffer.
+   *
+   * @details
+   * The readers start over as well, so don't call this while they read.
    */
   forcedinline void clear() noexcept
   {
     ringBuffer.clear();
-    writePosition = 0;
+    pyramid.clear();
+    writeCount.store(0, std::memory_order_release);
+    for (auto& cursor : readCursors) {
+      cursor.store(0, std::memory_order_release);
+    }
   }
 
   //============================================================================
@@ -260,46 +242,48 @@ public:
 protected:
   //============================================================================
   /**
-   * @brief Updates the write position in the ring buffer.
+   * @brief Copies samples into a channel, wrapping around the end.
    *
-   * @param _increment The amount to increment the write position.
+   * @param _channel The channel to write to.
+   * @param _position The raw index of the first sample.
+   * @param _samples The samples, at most the size of the buffer.
    */
-  forcedinline void updateWritePosition(const int _increment) noexcept
+  forcedinline void writeWrapped(const int _channel,
+                                 const int _position,
+                                 std::span<const SampleType> _samples) noexcept
   {
-    bool moveWriteOverRead = false;
-    int newWritePosition = (writePosition + _increment) % getNumSamples();
-    if (writePosition == readPositions[0]) [[unlikely]] {
-      writePosition = newWritePosition;
-      return;
-    }
+    const int numSamples = static_cast<int>(_samples.size());
+    const int firstSize = jmin(numSamples, getNumSamples() - _position);
+    SampleType* destination = ringBuffer.getWritePointer(_channel);
 
-    // Check if the new write position overlaps with any read positions
-    for (size_t channel = 0; channel < static_cast<size_t>(getNumChannels());
-         ++channel) {
-      for (size_t i = 0; i < static_cast<size_t>(_increment); ++i) {
-        if ((writePosition + static_cast<int>(i)) % getNumSamples() ==
-            readPositions[channel]) [[unlikely]] {
-          moveWriteOverRead = true;
-          break;
-        }
-      }
-    }
-    // Update write position
-    writePosition = newWritePosition;
+    std::copy_n(_samples.data(), firstSize, destination + _position);
+    std::copy_n(
+      _samples.data() + firstSize, numSamples - firstSize, destination);
+  }
 
-    // Update read positions if necessary
-    if (moveWriteOverRead) {
-      for (size_t channel = 0; channel < static_cast<size_t>(getNumChannels());
-           ++channel) {
-        readPositions[channel] = writePosition;
-      }
-    }
+  //============================================================================
+  /**
+   * @brief Publishes written samples to the readers.
+   *
+   * @param _increment The number of samples written.
+   *
+   * @details
+   * The release store makes the samples visible to every reader that loads
+   * the count. Readers that fall behind are caught up when they read next, so
+   * this is O(1) however many readers there are.
+   */
+  forcedinline void updateWritePosition(const int _increment) noexcept
+  {
+    const auto written = writeCount.load(std::memory_order_relaxed);
+    writeCount.store(written + _increment, std::memory_order_release);
   }
 
 private:
   AudioBuffer ringBuffer;
-  int writePosition;
-  std::vector<int> readPositions;
+  MinMaxPyramid<SampleType> pyramid;
+  typename RingBufferInterface::Count writeCount{ 0 };
+  typename RingBufferInterface::Cursors readCursors{};
+  std::atomic<int> numReaders{ 0 };
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RingAudioBuffer)
 };
@@ -30,8 +30,12 @@
 
 //==============================================================================
 
+#include "dsp/data/MinMaxPyramid.h"
 #include "dsp/data/RingAudioBuffer.h"
 #include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
 
 //==============================================================================
 
@@ -44,29 +48,74 @@ namespace data {
  * @brief Interface for a ring buffer that provides easy and efficient access to
  * audio samples.
  *
+ * @details
+ * The buffer has one writer and any number of registered readers, each with
+ * its own cursor. Cursors and the write count are absolute sample counts in
+ * atomics. The writer publishes a block by storing the new count with
+ * release, and readers load it with acquire, so all samples up to the count
+ * are visible. A reader the writer has lapped is detected by comparing its
+ * cursor with the count, and it skips ahead to the oldest sample still held.
+ * Nothing here locks.
+ *
+ * The oldest guard band of the buffer is never handed to readers, as that is
+ * where the writer copies its next block before publishing it. Each write
+ * publishes at most getGuardSize() samples, so a reader is safe as long as
+ * it finishes before the second write after it got its range.
+ *
  * @tparam SampleType The type of audio sample (e.g., float, double).
  */
 template<typename SampleType>
 class alignas(64) RingBufferInterface
 {
   using AudioBuffer = juce::AudioBuffer<SampleType>;
+  using Pyramid = dmt::dsp::data::MinMaxPyramid<SampleType>;
 
 public:
+  static constexpr int maxReaders = 8;
+
+  /** Returned by addReader() when all reader slots are taken. */
+  static constexpr int invalidReader = -1;
+
+  /** The guard band is this fraction of the buffer. */
+  static constexpr int guardDivisor = 4;
+
+  using MinMax = typename Pyramid::MinMax;
+
+  using Count = std::atomic<std::int64_t>;
+  using Cursors = std::array<Count, maxReaders>;
+
+  /**
+   * @brief The samples a reader has not read yet.
+   */
+  struct ReadRange
+  {
+    // Raw index of the first sample, pass it on to getSample()
+    int start;
+    // Number of samples, at most the size of the buffer minus the guard
+    int size;
+  };
+
   //============================================================================
   /**
    * @brief Constructs a RingBufferInterface with the given audio buffer and
    * positions.
    *
    * @param _audioBuffer The audio buffer to use.
-   * @param _writePosition The write position in the buffer.
-   * @param _readPosition The read positions for each channel.
+   * @param _pyramid The min/max summary of the audio buffer.
+   * @param _writeCount The number of samples written so far.
+   * @param _readCursors The number of samples each reader has read.
+   * @param _numReaders The number of registered readers.
    */
   constexpr RingBufferInterface(AudioBuffer& _audioBuffer,
-                                const int& _writePosition,
-                                std::vector<int>& _readPosition) noexcept
+                                const Pyramid& _pyramid,
+                                const Count& _writeCount,
+                                Cursors& _readCursors,
+                                std::atomic<int>& _numReaders) noexcept
     : audioBuffer(_audioBuffer)
-    , writePosition(_writePosition)
-    , readPosition(_readPosition)
+    , pyramid(_pyramid)
+    , writeCount(_writeCount)
+    , readCursors(_readCursors)
+    , numReaders(_numReaders)
   {
   }
 
@@ -75,110 +124,194 @@ public:
    * @brief Retrieves a sample from the buffer.
    *
    * @param _channel The channel to read from.
-   * @param _sample The sample index to read.
+   * @param _sample The raw sample index, may run up to one buffer past the end.
    * @return The sample value.
    */
   forcedinline SampleType getSample(const int _channel,
                                     const int _sample) const noexcept
   {
     const int numSamples = audioBuffer.getNumSamples();
-    const int block1size = numSamples - writePosition;
-    if (_sample < block1size) [[likely]] {
-      return audioBuffer.getSample(_channel, writePosition + _sample);
+    if (_sample < numSamples) [[likely]] {
+      return audioBuffer.getSample(_channel, _sample);
     }
-    return audioBuffer.getSample(_channel, _sample - block1size);
+    return audioBuffer.getSample(_channel, _sample - numSamples);
   }
 
   //============================================================================
   /**
-   * @brief Gets the read position for a specific channel.
+   * @brief Gets the smallest and largest sample of a range.
+   *
+   * @param _channel The channel to read from.
+   * @param _start The raw index of the first sample.
+   * @param _numSamples The number of samples.
+   * @return The extremes of the range.
    *
-   * @param _channel The channel index.
-   * @return The read position.
+   * @details
+   * Reads the min/max pyramid, so it costs about the same for 10 samples as
+   * for 10000.
    */
-  forcedinline int getReadPosition(int _channel) const noexcept
+  forcedinline MinMax getMinMax(const int _channel,
+                                const int _start,
+                                const int _numSamples) const noexcept
   {
-    const int numSamples = audioBuffer.getNumSamples();
-    const int rawReadPosition = readPosition[_channel];
-    if (rawReadPosition > writePosition) [[likely]] {
-      return rawReadPosition - writePosition;
-    }
-    return numSamples - writePosition + rawReadPosition;
+    return pyramid.getRange(audioBuffer, _channel, _start, _numSamples);
   }
 
   //============================================================================
   /**
-   * @brief Increments the read position for a specific channel.
+   * @brief Gets the size of the guard band, and of the largest block the
+   * writer publishes at once.
    *
-   * @param _channel The channel index.
-   * @param _increment The amount to increment.
+   * @param _numSamples The size of the buffer.
+   * @return The guard size, at least one sample.
    */
-  forcedinline void incrementReadPosition(int _channel, int _increment) noexcept
+  [[nodiscard]] static constexpr int getGuardSize(
+    const int _numSamples) noexcept
   {
-    const int numSamples = audioBuffer.getNumSamples();
-    const int oldReadPosition = readPosition[_channel];
-    const int newReadPosition = (oldReadPosition + _increment) % numSamples;
-    readPosition[_channel] = newReadPosition;
+    return std::max(_numSamples / guardDivisor, 1);
   }
 
   //============================================================================
   /**
-   * @brief Sets the raw read position for a specific channel.
+   * @brief Registers a new reader.
    *
-   * @param _channel The channel index.
-   * @param _position The new read position.
+   * @return The reader, starting at the newest sample, or invalidReader if
+   * all maxReaders slots are taken.
+   *
+   * @details
+   * Safe to call while the buffer is written and read.
    */
-  forcedinline void setRawReadPosition(const int _channel,
-                                       const int _position) noexcept
+  [[nodiscard]] inline int addReader() noexcept
   {
-    readPosition[_channel] = _position;
+    int reader = numReaders.load(std::memory_order_acquire);
+    do {
+      if (reader >= maxReaders) {
+        jassertfalse;
+        return invalidReader;
+      }
+    } while (!numReaders.compare_exchange_weak(
+      reader, reader + 1, std::memory_order_acq_rel));
+
+    const auto written = writeCount.load(std::memory_order_acquire);
+    readCursors[static_cast<size_t>(reader)].store(written,
+                                                   std::memory_order_release);
+    return reader;
   }
 
   //============================================================================
   /**
-   * @brief Gets the raw read position for a specific channel.
+   * @brief Gets the samples a reader has not read yet.
    *
-   * @param _channel The channel index.
-   * @return The raw read position.
+   * @param _reader The reader, not invalidReader.
+   * @return The range of unread samples, outside the guard band.
    */
-  forcedinline int getRawReadPosition(const int _channel) const noexcept
+  forcedinline ReadRange getReadRange(const int _reader) noexcept
   {
-    return readPosition[_channel];
+    jassert(_reader >= 0 && _reader < maxReaders);
+    const std::int64_t numSamples = audioBuffer.getNumSamples();
+    const std::int64_t readable =
+      numSamples - getGuardSize(static_cast<int>(numSamples));
+    const auto written = writeCount.load(std::memory_order_acquire);
+    const auto oldest = std::max(written - readable, std::int64_t(0));
+
+    auto& cursor = readCursors[static_cast<size_t>(_reader)];
+    auto position = cursor.load(std::memory_order_acquire);
+    if (position < oldest) [[unlikely]] {
+      // The writer lapped this reader, so it continues at the oldest sample
+      advanceCursor(cursor, oldest);
+      position = std::max(oldest, cursor.load(std::memory_order_acquire));
+    }
+
+    return { static_cast<int>(position % numSamples),
+             static_cast<int>(written - position) };
   }
 
   //============================================================================
   /**
-   * @brief Equalizes the read positions across all channels.
+   * @brief Gets the newest samples and marks them as read.
+   *
+   * @param _reader The reader, not invalidReader.
+   * @param _numSamples The number of samples wanted.
+   * @return The newest samples, fewer if not as many were written or are
+   * outside the guard band.
+   *
+   * @details
+   * Lets a reader draw its whole history again, e.g. after a zoom change,
+   * and continue after it.
+   */
+  forcedinline ReadRange getHistoryRange(const int _reader,
+                                         const int _numSamples) noexcept
+  {
+    jassert(_reader >= 0 && _reader < maxReaders);
+    const std::int64_t numSamples = audioBuffer.getNumSamples();
+    const std::int64_t readable =
+      numSamples - getGuardSize(static_cast<int>(numSamples));
+    const auto written = writeCount.load(std::memory_order_acquire);
+    const auto size = std::min(
+      { static_cast<std::int64_t>(_numSamples), readable, written });
+
+    advanceCursor(readCursors[static_cast<size_t>(_reader)], written);
+
+    return { static_cast<int>((written - size) % numSamples),
+             static_cast<int>(size) };
+  }
+
+  //============================================================================
+  /**
+   * @brief Increments the read position of a reader.
+   *
+   * @param _reader The reader, not invalidReader.
+   * @param _increment The amount to increment.
+   */
+  forcedinline void incrementReadPosition(const int _reader,
+                                          const int _increment) noexcept
+  {
+    jassert(_reader >= 0 && _reader < maxReaders);
+    auto& cursor = readCursors[static_cast<size_t>(_reader)];
+    const auto position = cursor.load(std::memory_order_acquire);
+    advanceCursor(cursor, position + _increment);
+  }
+
+  //============================================================================
+  /**
+   * @brief Moves all readers up to the one that has read the most.
    */
   forcedinline void equalizeReadPositions() noexcept
   {
-    int highestReadPosition = 0;
-    int highestReadChannel = 0;
-
-    // Find the highest read position among all channels
-    for (size_t channel = 0; channel < audioBuffer.getNumChannels();
-         ++channel) {
-      const int readPos = getReadPosition(static_cast<int>(channel));
-      if (readPos > highestReadPosition) [[likely]] {
-        highestReadPosition = readPos;
-        highestReadChannel = static_cast<int>(channel);
-      }
-    }
+    const int readers = numReaders.load(std::memory_order_acquire);
 
-    // Get the raw read position for the channel with the highest read position
-    const int highestRawReadPosition = getRawReadPosition(highestReadChannel);
+    std::int64_t highestCursor = 0;
+    for (int reader = 0; reader < readers; ++reader) {
+      const auto& cursor = readCursors[static_cast<size_t>(reader)];
+      highestCursor =
+        std::max(highestCursor, cursor.load(std::memory_order_acquire));
+    }
 
-    // Set all channels to the highest raw read position found
-    for (size_t channel = 0; channel < audioBuffer.getNumChannels();
-         ++channel) {
-      setRawReadPosition(static_cast<int>(channel), highestRawReadPosition);
+    for (int reader = 0; reader < readers; ++reader) {
+      advanceCursor(readCursors[static_cast<size_t>(reader)], highestCursor);
     }
   }
 
 private:
+  //============================================================================
+  /**
+   * @brief Moves a cursor forward, never back, even if it is moved elsewhere.
+   */
+  static forcedinline void advanceCursor(Count& _cursor,
+                                         const std::int64_t _target) noexcept
+  {
+    auto current = _cursor.load(std::memory_order_relaxed);
+    while (current < _target &&
+           !_cursor.compare_exchange_weak(
+             current, _target, std::memory_order_acq_rel)) {
+    }
+  }
+
   AudioBuffer& audioBuffer;
-  const int& writePosition;
-  std::vector<int>& readPosition;
+  const Pyramid& pyramid;
+  const Count& writeCount;
+  Cursors& readCursors;
+  std::atomic<int>& numReaders;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RingBufferInterface)
 };
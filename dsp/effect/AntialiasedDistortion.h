@@ -0,0 +1,389 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Distortion with anti-aliasing. Uses first-order antiderivative anti-aliasing
+ * for the distortion types with a closed-form antiderivative and 2x
+ * oversampling for the others.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "dsp/effect/Distortion.h"
+#include "dsp/noise/NoiseGenerator.h"
+#include "utility/FastMath.h"
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace effect {
+
+//==============================================================================
+/**
+ * @brief Distortion effect processor with anti-aliasing.
+ *
+ * @details
+ * Produces the same sound as Distortion::processBuffer(), but with much less
+ * aliasing at high drive, without running the whole chain at a higher sample
+ * rate.
+ *
+ * Types with a closed-form antiderivative use first-order antiderivative
+ * anti-aliasing (ADAA). Each output sample is the mean of the distortion over
+ * the line between two input samples, which is the difference of the
+ * antiderivative divided by the difference of the samples. This costs about
+ * two evaluations of the distortion per sample and delays the signal by half
+ * a sample. Samples that are too close together for the division fall back
+ * to the distortion at their midpoint.
+ *
+ * Crunch and Weird have no closed-form antiderivative. They run at twice the
+ * sample rate with the polyphase IIR filters of juce::dsp::Oversampling.
+ * Atan leaves samples as they are and isn't processed differently at all.
+ *
+ * Girth and symmetry are applied at the original sample rate, like in
+ * Distortion.
+ */
+class alignas(64) AntialiasedDistortion
+{
+  using Type = Distortion::Type;
+  using KernelConstants = Distortion::KernelConstants;
+  using Oversampling = juce::dsp::Oversampling<float>;
+
+  // Input steps smaller than this use the midpoint, the division loses too
+  // much precision below it
+  static constexpr float tolerance = 1.0e-3f;
+
+public:
+  AntialiasedDistortion() = default;
+
+  //==============================================================================
+  /**
+   * @brief Prepares the processor for the given channel count and block size.
+   *
+   * @param _numChannels The number of channels.
+   * @param _maxBlockSize The maximum number of samples per block.
+   */
+  inline void prepare(const int _numChannels, const int _maxBlockSize)
+  {
+    maxBlockSize = _maxBlockSize;
+    previousInputs.assign(static_cast<size_t>(_numChannels), 0.0f);
+    oversampling = std::make_unique<Oversampling>(
+      static_cast<size_t>(_numChannels),
+      1,
+      Oversampling::filterHalfBandPolyphaseIIR,
+      false);
+    oversampling->initProcessing(static_cast<size_t>(_maxBlockSize));
+    girthNoise.setSeed(Distortion::makeGirthSeed());
+    reset();
+  }
+
+  //==============================================================================
+  /** @brief Clears the anti-aliasing state. */
+  inline void reset() noexcept
+  {
+    std::fill(previousInputs.begin(), previousInputs.end(), 0.0f);
+    if (oversampling != nullptr) {
+      oversampling->reset();
+    }
+    isOversampling = false;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Get the delay the anti-aliasing adds for a distortion type.
+   *
+   * @param _type The distortion type.
+   * @return The delay in samples.
+   */
+  [[nodiscard]] inline float getLatencyInSamples(
+    const Type _type) const noexcept
+  {
+    if (_type == Type::Atan) {
+      return 0.0f;
+    }
+    if (Distortion::hasAntiderivative(_type)) {
+      return 0.5f;
+    }
+    jassert(oversampling != nullptr);
+    return oversampling->getLatencyInSamples();
+  }
+
+  //==============================================================================
+  /**
+   * @brief Process an audio buffer with distortion, girth, and symmetry
+   * effects.
+   *
+   * @param _buffer The audio buffer.
+   * @param _type The distortion type.
+   * @param _symmetry The symmetry amount.
+   * @param _girth The girth amount.
+   * @param _drive The drive amount.
+   *
+   * @details
+   * Takes the girth seeds from the generator seeded in prepare().
+   */
+  inline void processBuffer(juce::AudioBuffer<float>& _buffer,
+                            const Type _type,
+                            const float _symmetry,
+                            const float _girth,
+                            const float _drive) noexcept
+  {
+    processBuffer(_buffer, _type, _symmetry, _girth, _drive, girthNoise);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Process an audio buffer with distortion, girth, and symmetry
+   * effects, taking the girth seeds from the given noise generator.
+   *
+   * @param _buffer The audio buffer.
+   * @param _type The distortion type.
+   * @param _symmetry The symmetry amount.
+   * @param _girth The girth amount.
+   * @param _drive The drive amount.
+   * @param _noise The noise generator, which is advanced by the buffer size.
+   */
+  inline void processBuffer(juce::AudioBuffer<float>& _buffer,
+                            const Type _type,
+                            const float _symmetry,
+                            const float _girth,
+                            const float _drive,
+                            noise::NoiseGenerator& _noise) noexcept
+  {
+    // The processor was not prepared for this buffer
+    jassert(oversampling != nullptr);
+    jassert(_buffer.getNumChannels() <=
+            static_cast<int>(previousInputs.size()));
+
+    switch (_type) {
+      case Type::Hardclip:
+        processBuffer<Type::Hardclip>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Softclip:
+        processBuffer<Type::Softclip>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Saturate:
+        processBuffer<Type::Saturate>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Atan:
+        processBuffer<Type::Atan>(_buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Crunch:
+        processBuffer<Type::Crunch>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Extreme:
+        processBuffer<Type::Extreme>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Scream:
+        processBuffer<Type::Scream>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Sine:
+        processBuffer<Type::Sine>(_buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Cosine:
+        processBuffer<Type::Cosine>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Harmonize:
+        processBuffer<Type::Harmonize>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Weird:
+        processBuffer<Type::Weird>(_buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Bitcrush:
+        processBuffer<Type::Bitcrush>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Apply first-order antiderivative anti-aliased distortion to a block.
+   *
+   * @tparam DistortionType The distortion type. Must have an antiderivative.
+   * @param _data The samples. Each must be within [-1, 1].
+   * @param _numSamples The number of samples, at most Distortion::chunkSize.
+   * @param _previousInput The input sample before the block, which is set to
+   *                       the last input sample of the block.
+   * @param _constants The constants for the current drive.
+   *
+   * @details
+   * The antiderivative at the previous input is evaluated again with the
+   * current constants, so the drive can change between blocks.
+   */
+  template<Type DistortionType>
+  static inline void antiderivativeBlock(
+    float* _data,
+    const int _numSamples,
+    float& _previousInput,
+    const KernelConstants& _constants) noexcept
+  {
+    jassert(_numSamples <= Distortion::chunkSize);
+
+    std::array<float, Distortion::chunkSize + 1> inputs;
+    std::array<float, Distortion::chunkSize + 1> integrals;
+    inputs[0] = _previousInput;
+    std::copy(_data, _data + _numSamples, inputs.begin() + 1);
+
+    for (int i = 0; i <= _numSamples; ++i) {
+      integrals[i] =
+        Distortion::antiderivativeKernel<DistortionType>(inputs[i], _constants);
+    }
+
+    // The fallback for small steps goes into the output first. GCC only
+    // vectorizes these loops when they are kept apart like this.
+    for (int i = 0; i < _numSamples; ++i) {
+      _data[i] = 0.5f * (inputs[i] + inputs[i + 1]);
+    }
+    for (int i = 0; i < _numSamples; ++i) {
+      _data[i] = Distortion::distortKernel<DistortionType>(_data[i], _constants);
+    }
+
+    // The division is done for every sample, a tiny step is never picked
+    for (int i = 0; i < _numSamples; ++i) {
+      const float delta = inputs[i + 1] - inputs[i];
+      const float slope = (integrals[i + 1] - integrals[i]) / delta;
+      _data[i] = dmt::math::branchlessSelect(
+        delta * delta > tolerance * tolerance, slope, _data[i]);
+    }
+
+    _previousInput = inputs[_numSamples];
+  }
+
+private:
+  //==============================================================================
+  template<Type DistortionType>
+  inline void processBuffer(juce::AudioBuffer<float>& _buffer,
+                            const float _symmetry,
+                            const float _girth,
+                            const float _drive,
+                            noise::NoiseGenerator& _noise) noexcept
+  {
+    if constexpr (DistortionType == Type::Atan) {
+      Distortion::processBuffer<DistortionType>(
+        _buffer, _symmetry, _girth, _drive, _noise);
+    } else if constexpr (Distortion::hasAntiderivative(DistortionType)) {
+      const KernelConstants constants(_drive);
+      Distortion::processBufferWith(
+        _buffer,
+        _symmetry,
+        _girth,
+        _noise,
+        [this, &constants](
+          const int _channel, float* _data, const int _numSamples) {
+          antiderivativeBlock<DistortionType>(
+            _data,
+            _numSamples,
+            previousInputs[static_cast<size_t>(_channel)],
+            constants);
+        });
+      isOversampling = false;
+    } else {
+      processOversampled<DistortionType>(
+        _buffer, _symmetry, _girth, _drive, _noise);
+    }
+  }
+
+  //==============================================================================
+  template<Type DistortionType>
+  inline void processOversampled(juce::AudioBuffer<float>& _buffer,
+                                 const float _symmetry,
+                                 const float _girth,
+                                 const float _drive,
+                                 noise::NoiseGenerator& _noise) noexcept
+  {
+    // Filter state left from an earlier block of this path is stale
+    if (!isOversampling) {
+      oversampling->reset();
+      isOversampling = true;
+    }
+
+    // Girth only, symmetry has to come after the distortion
+    Distortion::processBufferWith(
+      _buffer, 0.0f, _girth, _noise, [](const int, float*, const int) {});
+
+    const int numChannels = _buffer.getNumChannels();
+    const int numSamples = _buffer.getNumSamples();
+
+    // Keeps a switch to a type with an antiderivative free of a jump
+    if (numSamples > 0) {
+      for (int channel = 0; channel < numChannels; ++channel) {
+        previousInputs[static_cast<size_t>(channel)] =
+          _buffer.getSample(channel, numSamples - 1);
+      }
+    }
+
+    juce::dsp::AudioBlock<float> block(_buffer);
+
+    for (int start = 0; start < numSamples; start += maxBlockSize) {
+      const int blockSize = std::min(maxBlockSize, numSamples - start);
+      auto subBlock = block.getSubBlock(static_cast<size_t>(start),
+                                        static_cast<size_t>(blockSize));
+
+      auto oversampledBlock = oversampling->processSamplesUp(subBlock);
+      const auto oversampledSize =
+        static_cast<int>(oversampledBlock.getNumSamples());
+      for (int channel = 0; channel < numChannels; ++channel) {
+        Distortion::distortBlock<DistortionType>(
+          oversampledBlock.getChannelPointer(static_cast<size_t>(channel)),
+          oversampledSize,
+          _drive);
+      }
+      oversampling->processSamplesDown(subBlock);
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+      Distortion::symmetryBlock(
+        _buffer.getWritePointer(channel), numSamples, _symmetry);
+    }
+  }
+
+  //==============================================================================
+  std::unique_ptr<Oversampling> oversampling;
+  noise::NoiseGenerator girthNoise;
+  std::vector<float> previousInputs;
+  int maxBlockSize = 0;
+  bool isOversampling = false;
+
+  //==============================================================================
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AntialiasedDistortion)
+};
+
+//==============================================================================
+} // namespace effect
+} // namespace dsp
+} // namespace dmt
@@ -31,6 +31,8 @@
 
 //==============================================================================
 
+#include "dsp/filter/BiquadCascade.h"
+#include "model/CruulParameters.h"
 #include <JuceHeader.h>
 #include <utility/Settings.h>
 
@@ -51,7 +53,7 @@ class alignas(64) CruulProcessor
 {
   using AudioBuffer = juce::AudioBuffer<float>;
   using DelayLine = juce::dsp::DelayLine<float>;
-  using Filter = juce::IIRFilter;
+  using Filter = dmt::dsp::filter::BiquadCascade<2, 1>;
 
   // Add constexprs for min and max delay times (in ms)
   static constexpr float maxDelayMs = 240.0f;
@@ -78,6 +80,9 @@ public:
   inline void prepare(const double _newSampleRate,
                       const int _samplesPerBlock) noexcept
   {
+    // Look the parameters up once, so processBlock() doesn't have to
+    parameters.resolve(dmt::model::ParameterRegistry(apvts));
+
     sampleRate = static_cast<float>(_newSampleRate);
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
@@ -87,6 +92,21 @@ public:
     delayLine.setMaximumDelayInSamples((int)sampleRate);
   }
 
+  //==============================================================================
+  /**
+   * @brief Enables or disables anti-aliasing of the saturation.
+   *
+   * @param _shouldAntialias Whether to anti-alias the saturation.
+   *
+   * @details
+   * Uses first-order antiderivative anti-aliasing, as the atan saturation has
+   * a closed-form antiderivative. This delays the output by half a sample.
+   */
+  inline void setAntialiasing(const bool _shouldAntialias) noexcept
+  {
+    useAntialiasing = _shouldAntialias;
+  }
+
   //==============================================================================
   /**
    * @brief Processes an audio buffer.
@@ -99,49 +119,64 @@ public:
       return;
     }
 
-    const float drive = apvts.getRawParameterValue("CruulDrive")->load();
-    const float range = apvts.getRawParameterValue("CruulRange")->load();
-    const float tone =
-      apvts.getRawParameterValue("CruulFeedbackFilterCutoff")->load();
-    const float feedback = apvts.getRawParameterValue("CruulFeedback")->load();
-    const float mix = apvts.getRawParameterValue("CruulMix")->load();
-    const float saturation =
-      apvts.getRawParameterValue("CruulDistortion")->load();
+    const float drive = parameters.drive.load();
+    const float range = parameters.range.load();
+    const float tone = parameters.feedbackFilterCutoff.load();
+    const float feedback = parameters.feedback.load();
+    const float mix = parameters.mix.load();
+    const float saturation = parameters.distortion.load();
+
+    // The filter cascade doesn't flush its state, so we keep denormals away
+    juce::ScopedNoDenormals noDenormals;
+
+    // Both channels share the same tone filter coefficients
+    filter.setCoefficients(
+      0, juce::IIRCoefficients::makeLowPass(sampleRate, tone, 0.5f));
+
+    const int numChannels = juce::jmin(_buffer.getNumChannels(), 2);
+    auto* const* channelData = _buffer.getArrayOfWritePointers();
 
     // Applay the delay line to the input buffer
-    for (int channel = 0; channel < _buffer.getNumChannels(); ++channel) {
-      Filter& filter = channel == 0 ? leftFilter : rightFilter;
-      filter.setCoefficients(
-        juce::IIRCoefficients::makeLowPass(sampleRate, tone, 0.5f));
-      auto* channelData = _buffer.getWritePointer(channel);
-      for (int sample = 0; sample < _buffer.getNumSamples(); ++sample) {
-        // Dry signal
-        const float drySample = channelData[sample] + feedbackBuffer[channel];
+    for (int sample = 0; sample < _buffer.getNumSamples(); ++sample) {
+      // Dry signal
+      Filter::Frame drySamples = {};
+      for (int channel = 0; channel < numChannels; ++channel) {
+        drySamples[channel] =
+          channelData[channel][sample] + feedbackBuffer[channel];
+      }
+
+      // Both channels are filtered together in one SIMD register
+      Filter::Frame filteredSamples = drySamples;
+      filter.processFrame(filteredSamples, 1);
+
+      for (int channel = 0; channel < numChannels; ++channel) {
+        const float drySample = drySamples[channel];
         delayLine.pushSample(channel, drySample);
 
-        // Set delay time
+        // Get delay time
         const int delayInSamples =
-          getDelayInSamples(drySample, drive, range, filter);
-        delayLine.setDelay(delayInSamples);
+          getDelayInSamples(filteredSamples[channel], drive, range);
 
         // Output
-        const float wetSample = delayLine.popSample(channel);
+        const float wetSample =
+          delayLine.popSample(channel, static_cast<float>(delayInSamples));
         const float mixSample = (wetSample * mix) + (drySample * (1.0f - mix));
-        const float saturatedSample = processSaturation(mixSample, saturation);
-        channelData[sample] = saturatedSample;
+        const float saturatedSample =
+          useAntialiasing
+            ? processSaturationAntialiased(mixSample, saturation, channel)
+            : processSaturation(mixSample, saturation);
+        channelData[channel][sample] = saturatedSample;
         feedbackBuffer[channel] = wetSample * feedback;
       }
     }
   }
 
 protected:
-  int getDelayInSamples(const float _drySample,
+  int getDelayInSamples(const float _filteredSample,
                         const float _drive,
-                        const float _range,
-                        Filter& _filter) const noexcept
+                        const float _range) const noexcept
   {
-    const float filteredSample = _filter.processSingleSampleRaw(_drySample);
-    const float driveSample = filteredSample * _drive;
+    const float driveSample = _filteredSample * _drive;
     const float clampedSample = std::clamp(driveSample, -1.0f, 1.0f);
     const float denormalizedSample = (clampedSample + 1.0f) * 0.5f;
     const float multipliedSample = denormalizedSample * _range;
@@ -168,14 +203,54 @@ protected:
     return raw / normalizer;
   }
 
+  float processSaturationAntialiased(const float _sample,
+                                     const float _drive,
+                                     const int _channel) noexcept
+  {
+    const float previous = previousSaturationInputs[_channel];
+    previousSaturationInputs[_channel] = _sample;
+
+    // Without saturation this is the mean of both samples, as it is in the
+    // limit for a tiny drive
+    if (juce::approximatelyEqual(_drive, 0.0f)) {
+      return 0.5f * (_sample + previous);
+    }
+
+    // Too close together to divide, the mean is the saturated midpoint then
+    const double delta = static_cast<double>(_sample) - previous;
+    if (std::abs(delta) < 1.0e-5) {
+      return processSaturation(0.5f * (_sample + previous), _drive);
+    }
+
+    // Doubles, since the division cancels most digits of the difference
+    const double antiderivative =
+      getSaturationAntiderivative(_sample, _drive) -
+      getSaturationAntiderivative(previous, _drive);
+    return static_cast<float>(antiderivative / delta);
+  }
+
+  static double getSaturationAntiderivative(const float _sample,
+                                            const float _drive) noexcept
+  {
+    // Integral of atan(drive * x) / atan(drive) over x
+    const double x = _sample;
+    const double drive = _drive;
+    const double scaled = drive * x;
+    const double integral =
+      x * std::atan(scaled) - std::log1p(scaled * scaled) / (2.0 * drive);
+    return integral / std::atan(drive);
+  }
+
 private:
   //==============================================================================
   juce::AudioProcessorValueTreeState& apvts;
+  dmt::model::CruulParameterHandles parameters;
   DelayLine delayLine;
   float sampleRate = -1.0f;
-  std::array<float, 2> feedbackBuffer;
-  Filter leftFilter;
-  Filter rightFilter;
+  std::array<float, 2> feedbackBuffer = {};
+  std::array<float, 2> previousSaturationInputs = {};
+  bool useAntialiasing = false;
+  Filter filter;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CruulProcessor)
 };
@@ -30,6 +30,10 @@
 
 //==============================================================================
 
+#include "dsp/filter/AllpassSweepConvolver.h"
+#include "dsp/filter/AllpassSweepGenerator.h"
+#include "dsp/filter/BiquadCascade.h"
+#include "model/DisfluxParameters.h"
 #include <JuceHeader.h>
 #include <utility/Settings.h>
 
@@ -51,6 +55,9 @@ class alignas(64) DisfluxProcessor
   constexpr static int FILTER_AMOUNT = 256;
   constexpr static float MIN_FREQUENCY = 20.0f;
   constexpr static float MAX_FREQUENCY = 20000.0f;
+  constexpr static float CROSSFADE_TIME = 0.05f;
+  constexpr static int HISTORY_LENGTH = 4096;
+  constexpr static int PRIME_SLICE_LENGTH = HISTORY_LENGTH / 8;
 
   // Smoothing times (seconds) for each parameter
   const float& frequencySmoothTime;
@@ -66,10 +73,26 @@ class alignas(64) DisfluxProcessor
   int lastSmoothingInterval = 0;
 
   using AudioBuffer = juce::AudioBuffer<float>;
-  using Filter = juce::IIRFilter;
-  using FilterArray = std::array<Filter, FILTER_AMOUNT>;
+  using FilterCascade = dmt::dsp::filter::BiquadCascade<2, FILTER_AMOUNT>;
+  using HighpassFilter = dmt::dsp::filter::BiquadCascade<2, 1>;
+  using Convolver = dmt::dsp::filter::AllpassSweepConvolver;
 
 public:
+  //==============================================================================
+  /**
+   * @brief The order in which the filter cascade walks through a block.
+   *
+   * SampleMajor runs every stage for one sample before moving to the next
+   * sample. StageMajor splits the block at the smoothing boundaries and runs
+   * each stage over the whole sub-block before moving to the next stage.
+   * Both produce the same output, apart from float rounding in the smoothers.
+   */
+  enum class ProcessingOrder
+  {
+    SampleMajor,
+    StageMajor
+  };
+
   //==============================================================================
   /**
    * @brief Constructs a DisfluxProcessor with the given parameters.
@@ -116,6 +139,9 @@ public:
    */
   inline void prepare(const double _newSampleRate) noexcept
   {
+    // Look the parameters up once, so processBlock() doesn't have to
+    parameters.resolve(dmt::model::ParameterRegistry(apvts));
+
     sampleRate = static_cast<float>(_newSampleRate);
     smoothedFrequency.reset(sampleRate, frequencySmoothTime);
     smoothedSpread.reset(sampleRate, spreadSmoothTime);
@@ -130,13 +156,117 @@ public:
 
     // Prepare output highpass filter (default to 20 Hz)
     auto highpassCoeffs = juce::IIRCoefficients::makeHighPass(sampleRate, 20.0);
-    outputHighpassLeft.setCoefficients(highpassCoeffs);
-    outputHighpassRight.setCoefficients(highpassCoeffs);
-    outputHighpassLeft.reset();
-    outputHighpassRight.reset();
+    outputHighpass.setCoefficients(0, highpassCoeffs);
+    outputHighpass.reset();
 
     // Track last used frequency for output highpass
     lastHighpassFrequency = -1.0f;
+
+    // The first control point puts the cascade straight on its coefficients
+    snapCoefficients = true;
+    rampActive = false;
+
+    // Always start on the recursive cascade
+    convolutionGain = 0.0f;
+    convolutionWarmSamples = 0;
+    cascadeIdle = false;
+    primeRemaining = 0;
+
+    // Only prepare(double, int) sets the convolution engine up again
+    convolverPrepared = false;
+    maxBlockSize = 0;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Prepares the processor and the convolution engine.
+   *
+   * @param _newSampleRate The sample rate.
+   * @param _maxBlockSize The largest block processBlock() will receive.
+   *
+   * @details
+   * Only this overload makes the convolution engine available, as
+   * juce::dsp::Convolution needs to know the block size. It allocates, so it
+   * must not be called on the audio thread.
+   */
+  inline void prepare(const double _newSampleRate, const int _maxBlockSize)
+  {
+    prepare(_newSampleRate);
+
+    maxBlockSize = _maxBlockSize;
+    dryBuffer.setSize(2, _maxBlockSize);
+    convolutionBuffer.setSize(2, _maxBlockSize);
+    primeBuffer.setSize(2, _maxBlockSize + PRIME_SLICE_LENGTH);
+    historyBuffer.setSize(2, HISTORY_LENGTH);
+    historyBuffer.clear();
+    historyPosition = 0;
+    crossfadeStep = 1.0f / juce::jmax(1.0f, CROSSFADE_TIME * sampleRate);
+
+    convolver.prepare(_newSampleRate, _maxBlockSize);
+    convolverPrepared = true;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets the order in which the filter cascade processes a block.
+   *
+   * @param _order The processing order.
+   */
+  inline void setProcessingOrder(const ProcessingOrder _order) noexcept
+  {
+    processingOrder = _order;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Enables linear ramping of the coefficients between control points.
+   *
+   * @param _shouldRamp Whether to ramp the coefficients.
+   *
+   * @details
+   * Without ramping, the coefficients are recomputed every smoothingInterval
+   * samples and held in between, so small intervals are needed to avoid
+   * zipper noise. With ramping, each control point computes the coefficients
+   * for where the smoothers will be at the next control point, and the
+   * cascade moves towards them a little on every sample. This gives the
+   * sound of a fine interval with a coarse one, e.g. 64 to 256 samples.
+   *
+   * Ramping only runs while the parameters move. Once they settle, the
+   * cascade lands exactly on the final coefficients and the plain kernels
+   * are used again.
+   */
+  inline void setCoefficientRamping(const bool _shouldRamp) noexcept
+  {
+    rampCoefficients = _shouldRamp;
+    snapCoefficients = true;
+    rampActive = false;
+    smoothingIntervalCountdown = 0;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Enables the convolution engine for settled parameters.
+   *
+   * @param _shouldConvolve Whether to use the convolution engine.
+   *
+   * @details
+   * While frequency, spread and pinch are not moving, the cascade is a fixed
+   * linear filter. The engine then renders its impulse response in the
+   * background and applies it by FFT convolution, so the cost no longer
+   * depends on the amount. As soon as a parameter moves, the processor
+   * crossfades back to the recursive cascade.
+   *
+   * Before fading in, the convolution is fed for the length of the impulse
+   * response so its output is complete. Before fading out, the cascade is
+   * primed with the last HISTORY_LENGTH input samples, a slice per block, so
+   * the switch doesn't cost a burst of CPU. Sweeps that ring for longer than
+   * the convolver accepts stay on the recursive cascade.
+   *
+   * Requires prepare(double, int).
+   */
+  inline void setConvolutionEngine(const bool _shouldConvolve) noexcept
+  {
+    useConvolution = _shouldConvolve;
   }
 
   //==============================================================================
@@ -151,13 +281,15 @@ public:
       return;
     }
 
+    // The cascade doesn't flush its state, so we keep denormals away here
+    juce::ScopedNoDenormals noDenormals;
+
     // Load parameters
-    const int newAmount = apvts.getRawParameterValue("DisfluxAmount")->load();
-    const int newSpread = apvts.getRawParameterValue("DisfluxSpread")->load();
-    const auto newFrequency =
-      apvts.getRawParameterValue("DisfluxFrequency")->load();
-    const auto newPinch = apvts.getRawParameterValue("DisfluxPinch")->load();
-    const auto mix = apvts.getRawParameterValue("DisfluxMix")->load();
+    const int newAmount = parameters.amount.load();
+    const int newSpread = parameters.spread.load();
+    const auto newFrequency = parameters.frequency.load();
+    const auto newPinch = parameters.pinch.load();
+    const auto mix = parameters.mix.load();
 
     // Test if smoothing values have changed
     if (!juce::approximatelyEqual(lastFrequencySmoothTime,
@@ -175,7 +307,8 @@ public:
     }
     // We last highpass values here as it's recalculated on each run anyways
     if (lastSmoothingInterval != smoothingInterval) {
-      smoothingIntervalCountdown = smoothingInterval;
+      // A running ramp was planned for the old interval, so start a new one
+      smoothingIntervalCountdown = rampCoefficients ? 0 : smoothingInterval;
       lastSmoothingInterval = smoothingInterval;
     }
 
@@ -190,15 +323,15 @@ public:
     // If the amount of filters has changed, reset the filters
     if (amount != newAmount) {
       amount = newAmount;
-      for (size_t filterIndex = 0; filterIndex < amount; ++filterIndex) {
-        leftFilters[filterIndex].reset();
-        rightFilters[filterIndex].reset();
-      }
+      filters.reset();
       needUpdateCoeffs = false;
       smoothedFrequency.skip(
         static_cast<int>(sampleRate * frequencySmoothTime));
       smoothedSpread.skip(static_cast<int>(sampleRate * spreadSmoothTime));
       smoothedPinch.skip(static_cast<int>(sampleRate * pinchSmoothTime));
+      // Stages that just became active may hold stale coefficients
+      snapCoefficients = true;
+      smoothingIntervalCountdown = 0;
     }
 
     // Output highpass filter: recalc coeffs only if freq changed and enabled
@@ -207,11 +340,226 @@ public:
                                   outputHighpassFrequency)) {
       auto highpassCoeffs = juce::IIRCoefficients::makeHighPass(
         sampleRate, outputHighpassFrequency);
-      outputHighpassLeft.setCoefficients(highpassCoeffs);
-      outputHighpassRight.setCoefficients(highpassCoeffs);
+      outputHighpass.setCoefficients(0, highpassCoeffs);
       lastHighpassFrequency = outputHighpassFrequency;
     }
 
+    const int numSamples = _buffer.getNumSamples();
+    const bool convolutionActive = useConvolution || convolutionGain > 0.0f;
+    if (convolverPrepared && convolutionActive && numSamples <= maxBlockSize) {
+      processWithConvolution(_buffer, mix);
+    } else {
+      // Blocks larger than prepared can't be convolved, so fall back hard
+      if (cascadeIdle) {
+        filters.reset();
+        cascadeIdle = false;
+        primeRemaining = 0;
+        smoothingIntervalCountdown = 0;
+      }
+      convolutionGain = 0.0f;
+      convolutionWarmSamples = 0;
+      processCascade(_buffer, mix);
+    }
+
+    // Apply output highpass filter if enabled
+    if (useOutputHighpass) {
+      outputHighpass.processStageMajor(
+        _buffer.getArrayOfWritePointers(), numSamples, 1);
+    }
+  }
+
+protected:
+  //==============================================================================
+  /**
+   * @brief Runs the recursive cascade in the selected order and mixes.
+   *
+   * @param _buffer The audio buffer.
+   * @param _mix The wet/dry mix.
+   */
+  inline void processCascade(AudioBuffer& _buffer, const float _mix) noexcept
+  {
+    if (processingOrder == ProcessingOrder::StageMajor) {
+      processStageMajor(_buffer, _mix);
+    } else {
+      processSampleMajor(_buffer, _mix);
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Processes a block with the convolution engine in the loop.
+   *
+   * @param _buffer The audio buffer.
+   * @param _mix The wet/dry mix.
+   *
+   * @details
+   * The convolution is only fed while it is ready for the current settings or
+   * still audible. The cascade only runs while it is audible or about to be.
+   * An idle cascade is primed first, and the convolution holds the output
+   * until that is done.
+   */
+  inline void processWithConvolution(AudioBuffer& _buffer,
+                                     const float _mix) noexcept
+  {
+    const int numSamples = _buffer.getNumSamples();
+
+    // Only a settled cascade can be replaced by its impulse response
+    const bool settled = !smoothedFrequency.isSmoothing() &&
+                         !smoothedSpread.isSmoothing() &&
+                         !smoothedPinch.isSmoothing() && !rampActive &&
+                         !snapCoefficients;
+    bool convolutionReady = false;
+    if (useConvolution && settled) {
+      const auto sweep = getSweep(smoothedFrequency.getCurrentValue(),
+                                  smoothedSpread.getCurrentValue(),
+                                  smoothedPinch.getCurrentValue());
+      convolver.request(sweep);
+      convolutionReady = convolver.isReadyFor(sweep);
+    }
+
+    const bool feedConvolution = convolutionReady || convolutionGain > 0.0f;
+    if (!feedConvolution) {
+      convolutionWarmSamples = 0;
+      processCascade(_buffer, _mix);
+      return;
+    }
+
+    // The convolution swaps impulse responses a few blocks after loading
+    const int warmupLength = convolver.getImpulseLength() + 2 * maxBlockSize;
+    const bool warm = convolutionWarmSamples >= warmupLength;
+    const bool fadeIn = convolutionReady && warm;
+
+    for (int channel = 0; channel < 2; ++channel) {
+      dryBuffer.copyFrom(channel, 0, _buffer, channel, 0, numSamples);
+      convolutionBuffer.copyFrom(channel, 0, _buffer, channel, 0, numSamples);
+    }
+    writeHistory(numSamples);
+    convolver.process(convolutionBuffer, numSamples);
+    convolutionWarmSamples =
+      juce::jmin(convolutionWarmSamples + numSamples, warmupLength);
+
+    // The cascade is skipped once the convolution has fully taken over
+    const bool cascadeAudible = convolutionGain < 1.0f || !fadeIn;
+    bool cascadeProcessed = false;
+    if (!cascadeAudible) {
+      // Any priming in progress is stale once the cascade goes idle again
+      cascadeIdle = true;
+      primeRemaining = 0;
+    } else if (cascadeIdle) {
+      primeCascade(numSamples);
+      // Priming runs on the old coefficients, the smoothers carry on meanwhile
+      smoothedFrequency.skip(numSamples);
+      smoothedSpread.skip(numSamples);
+      smoothedPinch.skip(numSamples);
+    } else {
+      processCascade(_buffer, 1.0f);
+      cascadeProcessed = true;
+    }
+
+    // The gain holds while there is no cascade output to fade to
+    const float step = !cascadeProcessed ? 0.0f
+                       : fadeIn          ? crossfadeStep
+                                         : -crossfadeStep;
+    const auto wetGain = _mix;
+    const auto dryGain = 1.0f - wetGain;
+    float gain = convolutionGain;
+    for (int sample = 0; sample < numSamples; ++sample) {
+      gain = juce::jlimit(0.0f, 1.0f, gain + step);
+      for (int channel = 0; channel < 2; ++channel) {
+        const float convolved = convolutionBuffer.getSample(channel, sample);
+        const float wet =
+          cascadeProcessed
+            ? (convolved * gain) +
+                (_buffer.getSample(channel, sample) * (1.0f - gain))
+            : convolved;
+        const float dry = dryBuffer.getSample(channel, sample);
+        _buffer.setSample(channel, sample, (wet * wetGain) + (dry * dryGain));
+      }
+    }
+    convolutionGain = gain;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Remembers the latest input while the convolution is in the loop.
+   *
+   * @param _numSamples The number of samples in dryBuffer.
+   */
+  inline void writeHistory(const int _numSamples) noexcept
+  {
+    const int count = juce::jmin(_numSamples, HISTORY_LENGTH);
+    const int start = _numSamples - count;
+    const int firstPart = juce::jmin(count, HISTORY_LENGTH - historyPosition);
+    for (int channel = 0; channel < 2; ++channel) {
+      historyBuffer.copyFrom(
+        channel, historyPosition, dryBuffer, channel, start, firstPart);
+      historyBuffer.copyFrom(
+        channel, 0, dryBuffer, channel, start + firstPart, count - firstPart);
+    }
+    historyPosition = (historyPosition + count) % HISTORY_LENGTH;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Brings an idle cascade back to a plausible state, a slice a block.
+   *
+   * @param _numSamples The number of samples writeHistory() just added.
+   *
+   * @details
+   * Runs the remembered input through the cleared cascade, oldest sample
+   * first, with the coefficients it had when it went idle. Each block catches
+   * up on its own samples plus PRIME_SLICE_LENGTH of the backlog, so the
+   * whole history is through after a few blocks. The next control point then
+   * moves the cascade on from there.
+   */
+  inline void primeCascade(const int _numSamples) noexcept
+  {
+    if (primeRemaining == 0) {
+      // The block just written is part of the history, so it's all pending
+      filters.reset();
+      primePosition = historyPosition;
+      primeRemaining = HISTORY_LENGTH;
+    } else {
+      primeRemaining += juce::jmin(_numSamples, HISTORY_LENGTH);
+      if (primeRemaining > HISTORY_LENGTH) {
+        primePosition = historyPosition;
+        primeRemaining = HISTORY_LENGTH;
+      }
+    }
+
+    // The ring is copied out, so it stays intact if priming is abandoned
+    const int sliceLength =
+      juce::jmin(primeRemaining, _numSamples + PRIME_SLICE_LENGTH);
+    const int firstPart =
+      juce::jmin(sliceLength, HISTORY_LENGTH - primePosition);
+    for (int channel = 0; channel < 2; ++channel) {
+      primeBuffer.copyFrom(
+        channel, 0, historyBuffer, channel, primePosition, firstPart);
+      primeBuffer.copyFrom(
+        channel, firstPart, historyBuffer, channel, 0, sliceLength - firstPart);
+    }
+    filters.processStageMajor(primeBuffer.getArrayOfWritePointers(),
+                              sliceLength,
+                              static_cast<size_t>(amount));
+
+    primePosition = (primePosition + sliceLength) % HISTORY_LENGTH;
+    primeRemaining -= sliceLength;
+    if (primeRemaining == 0) {
+      cascadeIdle = false;
+      smoothingIntervalCountdown = 0;
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Runs the whole cascade for each sample in turn.
+   *
+   * @param _buffer The audio buffer.
+   * @param _mix The wet/dry mix.
+   */
+  inline void processSampleMajor(AudioBuffer& _buffer,
+                                 const float _mix) noexcept
+  {
     int numSamples = _buffer.getNumSamples();
     int smoothingCountdown = smoothingIntervalCountdown;
     float currentFrequency = smoothedFrequency.getCurrentValue();
@@ -222,89 +570,277 @@ public:
       // Smoothing interval logic: update filter coefficients every
       // smoothingInterval samples
       if (smoothingCountdown <= 0) {
-        currentFrequency = smoothedFrequency.getCurrentValue();
-        currentSpread = smoothedSpread.getCurrentValue();
-        currentPinch = smoothedPinch.getCurrentValue();
-        setCoefficients(currentFrequency, currentSpread, currentPinch);
-        smoothingCountdown = smoothingInterval;
+        if (rampCoefficients) {
+          smoothingCountdown = juce::jmax(1, smoothingInterval);
+          updateCoefficientRamp(smoothingCountdown);
+        } else {
+          currentFrequency = smoothedFrequency.getCurrentValue();
+          currentSpread = smoothedSpread.getCurrentValue();
+          currentPinch = smoothedPinch.getCurrentValue();
+          setCoefficients(currentFrequency, currentSpread, currentPinch);
+          smoothingCountdown = smoothingInterval;
+        }
       }
 
-      // Advance smoothing values for each sample
-      currentFrequency = smoothedFrequency.getNextValue();
-      currentSpread = smoothedSpread.getNextValue();
-      currentPinch = smoothedPinch.getNextValue();
+      // Advance smoothing values for each sample, ramping does it per interval
+      if (!rampCoefficients) {
+        currentFrequency = smoothedFrequency.getNextValue();
+        currentSpread = smoothedSpread.getNextValue();
+        currentPinch = smoothedPinch.getNextValue();
+      }
 
       smoothingCountdown--;
 
       auto const leftDry = _buffer.getSample(0, sample);
       auto const rightDry = _buffer.getSample(1, sample);
-      auto left = leftDry;
-      auto right = rightDry;
 
-      for (size_t filterIndex = 0; filterIndex < amount; ++filterIndex) {
-        left = leftFilters[filterIndex].processSingleSampleRaw(left);
-        right = rightFilters[filterIndex].processSingleSampleRaw(right);
+      // Both channels run through the cascade together
+      FilterCascade::Frame frame = { leftDry, rightDry };
+      if (rampActive) {
+        filters.processFrameRamped(frame, static_cast<size_t>(amount));
+      } else {
+        filters.processFrame(frame, static_cast<size_t>(amount));
       }
 
-      const auto wetGain = mix;
+      const auto wetGain = _mix;
       const auto dryGain = 1.0f - wetGain;
-      left = (left * wetGain) + (leftDry * dryGain);
-      right = (right * wetGain) + (rightDry * dryGain);
+      frame[0] = (frame[0] * wetGain) + (leftDry * dryGain);
+      frame[1] = (frame[1] * wetGain) + (rightDry * dryGain);
+
+      _buffer.setSample(0, sample, frame[0]);
+      _buffer.setSample(1, sample, frame[1]);
+    }
+    smoothingIntervalCountdown = smoothingCountdown;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Runs each stage over a whole sub-block before the next stage.
+   *
+   * @param _buffer The audio buffer.
+   * @param _mix The wet/dry mix.
+   *
+   * @details
+   * The coefficients only change at smoothing boundaries, so the block is
+   * split there and every sub-block is handed to the cascade in one go. The
+   * smoothers are skipped ahead by the length of each sub-block, which leaves
+   * them where the sample-major path would, up to float rounding.
+   */
+  inline void processStageMajor(AudioBuffer& _buffer,
+                                const float _mix) noexcept
+  {
+    const int numSamples = _buffer.getNumSamples();
+    // An interval below one recalculates on every sample, same as SampleMajor
+    const int interval = juce::jmax(1, smoothingInterval);
+    int smoothingCountdown = smoothingIntervalCountdown;
+    auto* const* channels = _buffer.getArrayOfWritePointers();
+
+    int sample = 0;
+    while (sample < numSamples) {
+      if (smoothingCountdown <= 0) {
+        if (rampCoefficients) {
+          updateCoefficientRamp(interval);
+        } else {
+          setCoefficients(smoothedFrequency.getCurrentValue(),
+                          smoothedSpread.getCurrentValue(),
+                          smoothedPinch.getCurrentValue());
+        }
+        smoothingCountdown = interval;
+      }
 
-      // Apply output highpass filter if enabled
-      if (useOutputHighpass) {
-        left = outputHighpassLeft.processSingleSampleRaw(left);
-        right = outputHighpassRight.processSingleSampleRaw(right);
+      // Coefficients stay constant (or on one ramp) until the next boundary
+      const int segmentLength =
+        juce::jmin(smoothingCountdown, numSamples - sample);
+      if (!rampCoefficients) {
+        smoothedFrequency.skip(segmentLength);
+        smoothedSpread.skip(segmentLength);
+        smoothedPinch.skip(segmentLength);
       }
+      smoothingCountdown -= segmentLength;
 
-      _buffer.setSample(0, sample, left);
-      _buffer.setSample(1, sample, right);
+      processSegment(channels, sample, segmentLength, _mix);
+      sample += segmentLength;
     }
     smoothingIntervalCountdown = smoothingCountdown;
   }
 
-protected:
+  //==============================================================================
+  /**
+   * @brief Filters and mixes a sub-block with fixed coefficients.
+   *
+   * @param _channels The channel pointers of the buffer.
+   * @param _startSample The first sample of the sub-block.
+   * @param _numSamples The length of the sub-block.
+   * @param _mix The wet/dry mix.
+   */
+  inline void processSegment(float* const* _channels,
+                             const int _startSample,
+                             const int _numSamples,
+                             const float _mix) noexcept
+  {
+    const auto wetGain = _mix;
+    const auto dryGain = 1.0f - wetGain;
+
+    // Work in chunks so the dry signal fits into a fixed scratch buffer
+    for (int offset = 0; offset < _numSamples;
+         offset += FilterCascade::chunkSize) {
+      const int chunkLength =
+        juce::jmin(FilterCascade::chunkSize, _numSamples - offset);
+      float* const chunkChannels[2] = { _channels[0] + _startSample + offset,
+                                        _channels[1] + _startSample + offset };
+
+      for (size_t channel = 0; channel < 2; ++channel) {
+        std::copy(chunkChannels[channel],
+                  chunkChannels[channel] + chunkLength,
+                  dryChunk[channel].begin());
+      }
+
+      if (rampActive) {
+        filters.processStageMajorRamped(
+          chunkChannels, chunkLength, static_cast<size_t>(amount));
+      } else {
+        filters.processStageMajor(
+          chunkChannels, chunkLength, static_cast<size_t>(amount));
+      }
+
+      for (size_t channel = 0; channel < 2; ++channel) {
+        for (int i = 0; i < chunkLength; ++i) {
+          chunkChannels[channel][i] = (chunkChannels[channel][i] * wetGain) +
+                                      (dryChunk[channel][i] * dryGain);
+        }
+      }
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Plans the coefficient ramp up to the next control point.
+   *
+   * @param _interval The number of samples until the next control point.
+   *
+   * @details
+   * Advances the smoothers to where they will be at the next control point
+   * and ramps the cascade towards the coefficients for those values. When
+   * the values have not moved since the last ramp, the cascade is put
+   * exactly on its targets and no ramp is started.
+   */
+  inline void updateCoefficientRamp(const int _interval) noexcept
+  {
+    smoothedFrequency.skip(_interval);
+    smoothedSpread.skip(_interval);
+    smoothedPinch.skip(_interval);
+
+    const float nextFrequency = smoothedFrequency.getCurrentValue();
+    const float nextSpread = smoothedSpread.getCurrentValue();
+    const float nextPinch = smoothedPinch.getCurrentValue();
+    const auto numStages = static_cast<size_t>(amount);
+
+    const bool settled =
+      juce::approximatelyEqual(nextFrequency, rampFrequency) &&
+      juce::approximatelyEqual(nextSpread, rampSpread) &&
+      juce::approximatelyEqual(nextPinch, rampPinch);
+    if (settled && !snapCoefficients) {
+      if (rampActive) {
+        filters.jumpToRampTargets(numStages);
+        rampActive = false;
+      }
+      return;
+    }
+
+    rampFrequency = nextFrequency;
+    rampSpread = nextSpread;
+    rampPinch = nextPinch;
+    generateCoefficients(
+      filters.getRampTargets(), nextFrequency, nextSpread, nextPinch);
+
+    if (snapCoefficients) {
+      filters.jumpToRampTargets(numStages);
+      snapCoefficients = false;
+      rampActive = false;
+    } else {
+      filters.startRamp(numStages, _interval);
+      rampActive = true;
+    }
+  }
+
   //==============================================================================
   /**
    * @brief Sets the coefficients for the filters.
+   *
+   * All active stages are computed in one vectorized pass, see
+   * AllpassSweepGenerator.
    */
   inline void setCoefficients(float freq, float sprd, float pnch) noexcept
+  {
+    generateCoefficients(filters.getCoefficients(), freq, sprd, pnch);
+    snapCoefficients = false;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Computes the coefficients for the given parameters.
+   *
+   * @param _target The coefficient arrays to write into.
+   * @param freq The center frequency.
+   * @param sprd The spread around the center frequency.
+   * @param pnch The quality factor of each stage.
+   */
+  inline void generateCoefficients(FilterCascade::Coefficients& _target,
+                                   float freq,
+                                   float sprd,
+                                   float pnch) noexcept
+  {
+    const auto sweep = getSweep(freq, sprd, pnch);
+    dmt::dsp::filter::AllpassSweepGenerator::generate(
+      _target,
+      static_cast<size_t>(sweep.numStages),
+      sweep.startFrequency,
+      sweep.endFrequency,
+      sweep.q,
+      sampleRate);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Describes the sweep of the cascade for the given parameters.
+   *
+   * @param freq The center frequency.
+   * @param sprd The spread around the center frequency.
+   * @param pnch The quality factor of each stage.
+   * @return The sweep with the current amount of stages.
+   */
+  [[nodiscard]] inline Convolver::Sweep getSweep(float freq,
+                                                 float sprd,
+                                                 float pnch) const noexcept
   {
     const float spreadAmount = sprd;
     const float rangeStartFrequency =
       juce::jlimit(MIN_FREQUENCY, MAX_FREQUENCY, freq - (spreadAmount / 2.0f));
     const float rangeEndFrequency =
       juce::jlimit(MIN_FREQUENCY, MAX_FREQUENCY, freq + (spreadAmount / 2.0f));
-
-    const float logStartFrequency = std::log(rangeStartFrequency);
-    const float logEndFrequency = std::log(rangeEndFrequency);
-    const float logFrequencyDelta = logEndFrequency - logStartFrequency;
-
-    for (size_t filterIndex = 0; filterIndex < amount; ++filterIndex) {
-      const float logFrequencyOffsetFactor =
-        (amount == 1) ? 0.5f : static_cast<float>(filterIndex) / (amount - 1);
-
-      const float logFrequency = std::exp(
-        logStartFrequency + (logFrequencyDelta * logFrequencyOffsetFactor));
-
-      const auto coefficients = juce::IIRCoefficients::makeAllPass(
-        static_cast<double>(sampleRate), logFrequency, pnch);
-
-      leftFilters[filterIndex].setCoefficients(coefficients);
-      rightFilters[filterIndex].setCoefficients(coefficients);
-    }
+    return { rangeStartFrequency, rangeEndFrequency, pnch, amount };
   }
 
 private:
   //==============================================================================
   juce::AudioProcessorValueTreeState& apvts;
+  dmt::model::DisfluxParameterHandles parameters;
   float sampleRate = -1.0f;
   int amount = 1;
   int spread = 0;
   float frequency = 800.0f;
   float pinch = 1.0f;
-  FilterArray leftFilters;
-  FilterArray rightFilters;
+  FilterCascade filters;
+  ProcessingOrder processingOrder = ProcessingOrder::SampleMajor;
+
+  // Coefficient ramping
+  bool rampCoefficients = false;
+  bool rampActive = false;
+  bool snapCoefficients = true;
+  float rampFrequency = 0.0f;
+  float rampSpread = 0.0f;
+  float rampPinch = 0.0f;
+  std::array<std::array<float, FilterCascade::chunkSize>, 2> dryChunk = {};
 
   // Smoothing
   juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>
@@ -313,9 +849,25 @@ private:
   juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedPinch;
   int smoothingIntervalCountdown = 0;
 
+  // Convolution engine
+  Convolver convolver;
+  bool useConvolution = false;
+  bool convolverPrepared = false;
+  bool cascadeIdle = false;
+  int maxBlockSize = 0;
+  float convolutionGain = 0.0f;
+  float crossfadeStep = 1.0f;
+  int convolutionWarmSamples = 0;
+  AudioBuffer dryBuffer;
+  AudioBuffer convolutionBuffer;
+  AudioBuffer historyBuffer;
+  int historyPosition = 0;
+  AudioBuffer primeBuffer;
+  int primePosition = 0;
+  int primeRemaining = 0;
+
   // Output highpass filter (configurable)
-  juce::IIRFilter outputHighpassLeft;
-  juce::IIRFilter outputHighpassRight;
+  HighpassFilter outputHighpass;
   float lastHighpassFrequency = -1.0f;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DisfluxProcessor)
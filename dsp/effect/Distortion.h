@@ -18,7 +18,9 @@
  * Your are not allowed to use this code in any closed-source project.
  *
  * Description:
- * Distortion effect processor.
+ * Distortion effect processor. Besides the scalar reference per sample, it has
+ * one kernel per type that processes whole blocks branch-free, so that the
+ * compiler can vectorize it across samples.
  *
  * Authors:
  * Lunix-420 (Primary Author)
@@ -29,9 +31,14 @@
 
 //==============================================================================
 
+#include "dsp/noise/NoiseGenerator.h"
+#include "utility/FastMath.h"
 #include <JuceHeader.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <limits>
 #include <random>
 #include <vector>
 
@@ -115,6 +122,9 @@ struct alignas(64) Distortion
    * @param _data The sample data.
    * @param _type The distortion type.
    * @param _drive The drive amount.
+   *
+   * @note This is the reference the block kernels are checked against. Use
+   *       processBuffer() or distortBlock() to process audio.
    */
   static inline void distortSample(float& _data,
                                    const Type _type,
@@ -238,6 +248,43 @@ struct alignas(64) Distortion
     }
   }
 
+  //==============================================================================
+  /**
+   * @brief Get the noise generator processBuffer() uses by default.
+   *
+   * @return The noise generator of the calling thread.
+   *
+   * @details
+   * Each thread gets its own generator. Its seed is the one drawn when the
+   * library is loaded plus the number of threads that got a generator
+   * before, so no two threads play the same noise and no thread touches
+   * std::random_device. Stateful processors should rather own a generator
+   * seeded with makeGirthSeed() in prepare() and pass it to processBuffer().
+   */
+  [[nodiscard]] static inline noise::NoiseGenerator& getGirthNoise() noexcept
+  {
+    static thread_local noise::NoiseGenerator generator(
+      defaultGirthSeed +
+      girthThreadCount.fetch_add(1, std::memory_order_relaxed));
+    return generator;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Draw a random seed for a girth noise generator.
+   *
+   * @return The seed.
+   *
+   * @details
+   * Reads std::random_device, which may make a system call, so only call it
+   * while preparing and never on the audio thread.
+   */
+  [[nodiscard]] static inline std::uint64_t makeGirthSeed()
+  {
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+  }
+
   //==============================================================================
   /**
    * @brief Generate a new random seed for girth effect.
@@ -246,10 +293,11 @@ struct alignas(64) Distortion
    */
   [[nodiscard]] static inline float getNewGirthSeed() noexcept
   {
-    static thread_local std::mt19937 generator{ std::random_device{}() };
-    static thread_local std::uniform_real_distribution<float> distribution(
-      0.0f, 100.0f);
-    return distribution(generator);
+    auto& generator = getGirthNoise();
+    float seed;
+    generator.fill(&seed, 1, 0, 0.0f, 100.0f);
+    generator.advance(1);
+    return seed;
   }
 
   //==============================================================================
@@ -317,6 +365,308 @@ struct alignas(64) Distortion
     _value = std::clamp(_value, -1.0f, 1.0f);
   }
 
+  //==============================================================================
+  /**
+   * @brief Values the block kernels derive from the drive.
+   *
+   * @details
+   * Computed once per block, so the kernels only do per-sample maths.
+   */
+  struct KernelConstants
+  {
+    float drive;
+    float saturateExponent;
+    float crunchExponent;
+    float extremeThreshold;
+    float screamMix;
+    float harmonizeGain;
+    float inverseHarmonizeGain;
+    float bitcrushSteps;
+    float inverseBitcrushSteps;
+    float inverseDrive;
+    float saturateAntiderivativeExponent;
+    float screamThreshold;
+    float screamOffset;
+
+    explicit KernelConstants(const float _drive) noexcept
+      : drive(_drive)
+      , saturateExponent(1.0f / ((_drive / 4.0f) + 0.75f))
+      // Zero drive would give an infinite exponent and 0 * inf for x = 1
+      , crunchExponent(1.0f / std::max(_drive, 1.0e-3f))
+      , extremeThreshold((10.0f - _drive) / 9.0f)
+      , screamMix((_drive - 1.0f) / 10.0f)
+      , harmonizeGain(_drive * 5.0f)
+      , inverseHarmonizeGain(1.0f / (_drive * 5.0f))
+      , bitcrushSteps(std::pow(2.0f, 10.0f - _drive))
+      , inverseBitcrushSteps(1.0f / bitcrushSteps)
+      // Zero drive would give 0 * inf in the antiderivatives that divide by it
+      , inverseDrive(1.0f / std::max(_drive, 1.0e-6f))
+      , saturateAntiderivativeExponent(saturateExponent + 1.0f)
+      // Input magnitude at which the saturated sample reaches 0.5
+      , screamThreshold(std::pow(0.5f, 1.0f / saturateExponent))
+      // Keeps the antiderivative continuous at the threshold
+      , screamOffset(
+          3.0f * screamMix * screamThreshold -
+          6.0f * screamMix *
+            std::pow(screamThreshold, saturateAntiderivativeExponent) /
+            saturateAntiderivativeExponent)
+    {
+    }
+  };
+
+  //==============================================================================
+  /**
+   * @brief Check whether a distortion type has an antiderivative kernel.
+   *
+   * @param _type The distortion type.
+   * @return True if antiderivativeKernel() can be used for the type.
+   *
+   * @details
+   * Crunch and Weird have no closed-form antiderivative. Atan leaves every
+   * sample as it is, so there is nothing to anti-alias.
+   */
+  [[nodiscard]] static constexpr bool hasAntiderivative(
+    const Type _type) noexcept
+  {
+    return _type != Type::Atan && _type != Type::Crunch &&
+           _type != Type::Weird;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Apply distortion of a fixed type to a sample without branching.
+   *
+   * @tparam DistortionType The distortion type.
+   * @param _value The sample value. Must be within [-1, 1].
+   * @param _constants The constants for the current drive.
+   * @return The distorted sample.
+   *
+   * @details
+   * Matches distortSample() up to the error of the approximations in
+   * FastMath.h. Every case is computed and picked with a select, because a
+   * branch keeps the compiler from vectorizing the calling loop.
+   */
+  template<Type DistortionType>
+  [[nodiscard]] static forcedinline float distortKernel(
+    const float _value,
+    const KernelConstants& _constants) noexcept
+  {
+    using namespace dmt::math;
+
+    if constexpr (DistortionType == Type::Hardclip) {
+      return branchlessClamp(_constants.drive * _value, -1.0f, 1.0f);
+    } else if constexpr (DistortionType == Type::Softclip) {
+      const float driven = _constants.drive * _value;
+      const float magnitude = std::abs(driven);
+      const float knee = 2.0f - 3.0f * magnitude;
+      const float shaped = branchlessSelect(
+        magnitude > 2.0f / 3.0f,
+        1.0f,
+        branchlessSelect(magnitude > 1.0f / 3.0f,
+                         1.0f - knee * knee / 3.0f,
+                         2.0f * magnitude));
+      return withSignOf(shaped, driven);
+    } else if constexpr (DistortionType == Type::Saturate) {
+      return saturateKernel(_value, _constants);
+    } else if constexpr (DistortionType == Type::Atan) {
+      // The reference only shapes samples that are approximately zero, which
+      // leaves every sample as it is once denormals are flushed
+      return _value;
+    } else if constexpr (DistortionType == Type::Crunch) {
+      // Only positive samples take this path, smaller ones are picked away
+      const float base =
+        branchlessSelect(_value < minNormal, minNormal, _value);
+      const float positive =
+        1.27f * fastAtan(fastPow(base, _constants.crunchExponent));
+      const float negative = branchlessClamp(
+        _constants.drive *
+          branchlessClamp(fastSin(_constants.drive * _value), -1.0f, 1.0f),
+        -1.0f,
+        1.0f);
+      return branchlessSelect(_value > 0.0f, positive, negative);
+    } else if constexpr (DistortionType == Type::Extreme) {
+      return branchlessSelect(std::abs(_value) >= _constants.extremeThreshold,
+                              withSignOf(1.0f, _value),
+                              _value);
+    } else if constexpr (DistortionType == Type::Scream) {
+      const float saturated = saturateKernel(_value, _constants);
+      const float folded = branchlessSelect(
+        saturated <= -0.5f,
+        4.0f * saturated + 3.0f,
+        branchlessSelect(
+          saturated < 0.5f, -2.0f * saturated, 4.0f * saturated - 3.0f));
+      return folded * _constants.screamMix +
+             saturated * (1.0f - _constants.screamMix);
+    } else if constexpr (DistortionType == Type::Sine) {
+      return branchlessClamp(fastSin(_constants.drive * _value), -1.0f, 1.0f);
+    } else if constexpr (DistortionType == Type::Cosine) {
+      return branchlessClamp(fastCos(_constants.drive * _value), -1.0f, 1.0f);
+    } else if constexpr (DistortionType == Type::Harmonize) {
+      const float driven = _value * _constants.harmonizeGain;
+      const float harmonics = fastSin(2.0f * driven) +
+                              fastSin(3.0f * driven) + fastSin(4.0f * driven);
+      return (harmonics + driven) * _constants.inverseHarmonizeGain;
+    } else if constexpr (DistortionType == Type::Weird) {
+      const float driven = _value * _constants.drive * 2.0f;
+      const float harmonics = fastSin(2.0f * driven) +
+                              fastSin(3.0f * driven) + fastSin(4.0f * driven);
+      return fastSin(harmonics + driven);
+    } else {
+      static_assert(DistortionType == Type::Bitcrush);
+      const float scaled = (_value + 1.0f) * _constants.bitcrushSteps;
+      return roundKernel(scaled) * _constants.inverseBitcrushSteps - 1.0f;
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Evaluate the antiderivative of a distortion type at a sample.
+   *
+   * @tparam DistortionType The distortion type. Must have an antiderivative.
+   * @param _value The sample value. Must be within [-1, 1].
+   * @param _constants The constants for the current drive.
+   * @return The antiderivative of distortKernel() at the sample.
+   *
+   * @details
+   * Used for first-order antiderivative anti-aliasing, which outputs the
+   * difference of the antiderivative between two samples divided by the
+   * difference of the samples. The antiderivatives are chosen to be zero at
+   * zero and to stay small, since that difference cancels most of their
+   * precision.
+   */
+  template<Type DistortionType>
+  [[nodiscard]] static forcedinline float antiderivativeKernel(
+    const float _value,
+    const KernelConstants& _constants) noexcept
+  {
+    static_assert(hasAntiderivative(DistortionType),
+                  "This distortion type has no antiderivative.");
+    using namespace dmt::math;
+
+    const float magnitude = std::abs(_value);
+    const float square = _value * _value;
+
+    if constexpr (DistortionType == Type::Hardclip) {
+      return branchlessSelect(_constants.drive * magnitude <= 1.0f,
+                              0.5f * _constants.drive * square,
+                              magnitude - 0.5f * _constants.inverseDrive);
+    } else if constexpr (DistortionType == Type::Softclip) {
+      const float driven = _constants.drive * magnitude;
+      const float knee = 2.0f - 3.0f * driven;
+      const float integral = branchlessSelect(
+        driven > 2.0f / 3.0f,
+        driven - 7.0f / 27.0f,
+        branchlessSelect(driven > 1.0f / 3.0f,
+                         driven - 2.0f / 9.0f - (1.0f - knee * knee * knee) /
+                                                  27.0f,
+                         driven * driven));
+      return integral * _constants.inverseDrive;
+    } else if constexpr (DistortionType == Type::Saturate) {
+      return saturateAntiderivative(magnitude, _constants);
+    } else if constexpr (DistortionType == Type::Extreme) {
+      const float threshold = _constants.extremeThreshold;
+      return branchlessSelect(magnitude < threshold,
+                              0.5f * square,
+                              magnitude - threshold +
+                                0.5f * threshold * threshold);
+    } else if constexpr (DistortionType == Type::Scream) {
+      const float mix = _constants.screamMix;
+      const float saturated = saturateAntiderivative(magnitude, _constants);
+      return branchlessSelect(magnitude < _constants.screamThreshold,
+                              (1.0f - 3.0f * mix) * saturated,
+                              (1.0f + 3.0f * mix) * saturated -
+                                3.0f * mix * magnitude +
+                                _constants.screamOffset);
+    } else if constexpr (DistortionType == Type::Sine) {
+      // Same as (1 - cos(drive * x)) / drive, without the constant offset
+      const float halfSine = fastSin(0.5f * _constants.drive * _value);
+      return 2.0f * halfSine * halfSine * _constants.inverseDrive;
+    } else if constexpr (DistortionType == Type::Cosine) {
+      return fastSin(_constants.drive * _value) * _constants.inverseDrive;
+    } else if constexpr (DistortionType == Type::Harmonize) {
+      const float driven = _value * _constants.harmonizeGain;
+      const float sine2 = fastSin(driven);
+      const float sine3 = fastSin(1.5f * driven);
+      const float sine4 = fastSin(2.0f * driven);
+      const float inverseGain = _constants.inverseHarmonizeGain;
+      return 0.5f * square +
+             2.0f * inverseGain * inverseGain *
+               (sine2 * sine2 / 2.0f + sine3 * sine3 / 3.0f +
+                sine4 * sine4 / 4.0f);
+    } else {
+      static_assert(DistortionType == Type::Bitcrush);
+      // The integral of round(u) from 0 to u is k * u - k^2 / 2, k = round(u)
+      const float scaled = (_value + 1.0f) * _constants.bitcrushSteps;
+      const float rounded = roundKernel(scaled);
+      const float inverseSteps = _constants.inverseBitcrushSteps;
+      return rounded * (scaled - 0.5f * rounded) * inverseSteps *
+               inverseSteps -
+             _value;
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Apply distortion of a fixed type to a block of samples.
+   *
+   * @tparam DistortionType The distortion type.
+   * @param _data The samples. Each must be within [-1, 1].
+   * @param _numSamples The number of samples.
+   * @param _drive The drive amount.
+   */
+  template<Type DistortionType>
+  static inline void distortBlock(float* _data,
+                                  const int _numSamples,
+                                  const float _drive) noexcept
+  {
+    const KernelConstants constants(_drive);
+    for (int i = 0; i < _numSamples; ++i) {
+      _data[i] = distortKernel<DistortionType>(_data[i], constants);
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Apply girth to a block of samples with one seed per sample.
+   *
+   * @param _data The samples.
+   * @param _seeds The girth seeds, in the range of getNewGirthSeed().
+   * @param _numSamples The number of samples.
+   * @param _girth The girth amount. Must not be negative.
+   */
+  static inline void girthBlock(float* _data,
+                                const float* _seeds,
+                                const int _numSamples,
+                                const float _girth) noexcept
+  {
+    const float scale = _girth / 100.0f;
+    for (int i = 0; i < _numSamples; ++i) {
+      _data[i] = dmt::math::branchlessClamp(
+        _data[i] * (_seeds[i] * scale + 1.0f), -1.0f, 1.0f);
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Apply symmetry to a block of samples.
+   *
+   * @param _data The samples.
+   * @param _numSamples The number of samples.
+   * @param _symmetry The symmetry amount.
+   */
+  static inline void symmetryBlock(float* _data,
+                                   const int _numSamples,
+                                   const float _symmetry) noexcept
+  {
+    const float positiveGain = 1.0f + _symmetry;
+    const float negativeGain = 1.0f - _symmetry;
+    for (int i = 0; i < _numSamples; ++i) {
+      const float gain = dmt::math::branchlessSelect(
+        _data[i] > 0.0f, positiveGain, negativeGain);
+      _data[i] = dmt::math::branchlessClamp(_data[i] * gain, -1.0f, 1.0f);
+    }
+  }
+
   //==============================================================================
   /**
    * @brief Process an audio buffer with distortion, girth, and symmetry
@@ -334,24 +684,220 @@ struct alignas(64) Distortion
                                    const float _girth,
                                    const float _drive) noexcept
   {
-    std::vector<float> girthSeeds;
-    if (_girth < 0.0f) {
-      girthSeeds = getGirthSeeds(_buffer.getNumSamples());
+    processBuffer(_buffer, _type, _symmetry, _girth, _drive, getGirthNoise());
+  }
+
+  //==============================================================================
+  /**
+   * @brief Process an audio buffer with distortion, girth, and symmetry
+   * effects, taking the girth seeds from the given noise generator.
+   *
+   * @param _buffer The audio buffer.
+   * @param _type The distortion type.
+   * @param _symmetry The symmetry amount.
+   * @param _girth The girth amount.
+   * @param _drive The drive amount.
+   * @param _noise The noise generator, which is advanced by the buffer size.
+   */
+  static inline void processBuffer(juce::AudioBuffer<float>& _buffer,
+                                   const Type _type,
+                                   const float _symmetry,
+                                   const float _girth,
+                                   const float _drive,
+                                   noise::NoiseGenerator& _noise) noexcept
+  {
+    switch (_type) {
+      case Type::Hardclip:
+        processBuffer<Type::Hardclip>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Softclip:
+        processBuffer<Type::Softclip>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Saturate:
+        processBuffer<Type::Saturate>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Atan:
+        processBuffer<Type::Atan>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Crunch:
+        processBuffer<Type::Crunch>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Extreme:
+        processBuffer<Type::Extreme>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Scream:
+        processBuffer<Type::Scream>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Sine:
+        processBuffer<Type::Sine>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Cosine:
+        processBuffer<Type::Cosine>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Harmonize:
+        processBuffer<Type::Harmonize>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Weird:
+        processBuffer<Type::Weird>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
+      case Type::Bitcrush:
+        processBuffer<Type::Bitcrush>(
+          _buffer, _symmetry, _girth, _drive, _noise);
+        break;
     }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Process an audio buffer with a fixed distortion type.
+   *
+   * @tparam DistortionType The distortion type.
+   * @param _buffer The audio buffer.
+   * @param _symmetry The symmetry amount.
+   * @param _girth The girth amount.
+   * @param _drive The drive amount.
+   * @param _noise The noise generator, which is advanced by the buffer size.
+   */
+  template<Type DistortionType>
+  static inline void processBuffer(juce::AudioBuffer<float>& _buffer,
+                                   const float _symmetry,
+                                   const float _girth,
+                                   const float _drive,
+                                   noise::NoiseGenerator& _noise) noexcept
+  {
+    processBufferWith(
+      _buffer,
+      _symmetry,
+      _girth,
+      _noise,
+      [_drive](const int, float* _data, const int _numSamples) {
+        distortBlock<DistortionType>(_data, _numSamples, _drive);
+      });
+  }
+
+  //==============================================================================
+  /**
+   * @brief Process an audio buffer with girth, symmetry and a custom
+   * distortion stage.
+   *
+   * @param _buffer The audio buffer.
+   * @param _symmetry The symmetry amount.
+   * @param _girth The girth amount.
+   * @param _noise The noise generator, which is advanced by the buffer size.
+   * @param _distortBlock Called as (channel, data, numSamples) for every
+   *                      chunk of every channel, in order.
+   *
+   * @details
+   * Works in chunks of at most chunkSize samples, so the girth seeds fit in a
+   * buffer on the stack. Negative girth shares the seeds of the first channel
+   * between all channels. Positive girth takes the seeds of each channel, so
+   * the channels only differ if the generator is decorrelated.
+   */
+  template<typename DistortBlock>
+  static inline void processBufferWith(juce::AudioBuffer<float>& _buffer,
+                                       const float _symmetry,
+                                       const float _girth,
+                                       noise::NoiseGenerator& _noise,
+                                       DistortBlock&& _distortBlock) noexcept
+  {
+    std::array<float, chunkSize> seeds;
+    const int numSamples = _buffer.getNumSamples();
+
+    for (int start = 0; start < numSamples; start += chunkSize) {
+      const int blockSize = std::min(chunkSize, numSamples - start);
+      if (_girth < 0.0f) {
+        _noise.fill(seeds.data(), blockSize, 0, 0.0f, 100.0f);
+      }
+
+      for (int channel = 0; channel < _buffer.getNumChannels(); ++channel) {
+        auto* channelData = _buffer.getWritePointer(channel) + start;
+        if (_girth > 0.0f) {
+          _noise.fill(seeds.data(), blockSize, channel, 0.0f, 100.0f);
+        }
 
-    for (int channel = 0; channel < _buffer.getNumChannels(); ++channel) {
-      auto* channelData = _buffer.getWritePointer(channel);
-      for (int sample = 0; sample < _buffer.getNumSamples(); ++sample) {
         if (_girth < 0.0f) {
-          girthSample(
-            channelData[sample], std::abs(_girth), girthSeeds[sample]);
+          girthBlock(channelData, seeds.data(), blockSize, -_girth);
+        } else if (_girth > 0.0f) {
+          girthBlock(channelData, seeds.data(), blockSize, _girth);
         } else {
-          girthSample(channelData[sample], _girth);
+          clampBlock(channelData, blockSize);
         }
 
-        distortSample(channelData[sample], _type, _drive);
-        symmetrySample(channelData[sample], _symmetry);
+        _distortBlock(channel, channelData, blockSize);
+        symmetryBlock(channelData, blockSize, _symmetry);
       }
+
+      _noise.advance(blockSize);
+    }
+  }
+
+  /** Maximum number of samples processBufferWith() passes at once. */
+  static constexpr int chunkSize = 256;
+
+private:
+  static constexpr float minNormal = std::numeric_limits<float>::min();
+
+  // Drawn once while the library is loaded, never on the audio thread
+  static inline const std::uint64_t defaultGirthSeed = makeGirthSeed();
+
+  // Offsets the seed of each thread's generator, see getGirthNoise()
+  static inline std::atomic<std::uint64_t> girthThreadCount{ 0 };
+
+  //==============================================================================
+  [[nodiscard]] static forcedinline float saturateKernel(
+    const float _value,
+    const KernelConstants& _constants) noexcept
+  {
+    // Magnitudes that fastPow() can't take are too small to be heard
+    const float magnitude = std::abs(_value);
+    const float shaped = dmt::math::fastPow(
+      dmt::math::branchlessSelect(magnitude < minNormal, minNormal, magnitude),
+      _constants.saturateExponent);
+    const float limited = dmt::math::branchlessSelect(
+      magnitude < minNormal,
+      0.0f,
+      dmt::math::branchlessSelect(shaped > 1.0f, 1.0f, shaped));
+    return dmt::math::withSignOf(limited, _value);
+  }
+
+  //==============================================================================
+  [[nodiscard]] static forcedinline float saturateAntiderivative(
+    const float _magnitude,
+    const KernelConstants& _constants) noexcept
+  {
+    const float exponent = _constants.saturateAntiderivativeExponent;
+    const float base =
+      dmt::math::branchlessSelect(_magnitude < minNormal, minNormal, _magnitude);
+    const float integral = dmt::math::fastPow(base, exponent);
+    return dmt::math::branchlessSelect(
+      _magnitude < minNormal, 0.0f, integral / exponent);
+  }
+
+  //==============================================================================
+  /** Truncating after adding 0.5 rounds half away from zero like std::round. */
+  [[nodiscard]] static forcedinline float roundKernel(
+    const float _value) noexcept
+  {
+    return static_cast<float>(
+      static_cast<int>(_value + dmt::math::withSignOf(0.5f, _value)));
+  }
+
+  //==============================================================================
+  static inline void clampBlock(float* _data, const int _numSamples) noexcept
+  {
+    for (int i = 0; i < _numSamples; ++i) {
+      _data[i] = dmt::math::branchlessClamp(_data[i], -1.0f, 1.0f);
     }
   }
 
@@ -361,4 +907,4 @@ struct alignas(64) Distortion
 //==============================================================================
 } // namespace effect
 } // namespace dsp
-} // namespace dmt
\ No newline at end of file
+} // namespace dmt
\ No newline at end of file
@@ -29,6 +29,7 @@
 
 //==============================================================================
 
+#include "./AntialiasedDistortion.h"
 #include "./CruulProcessor.h"
 #include "./DisfluxProcessor.h"
 #include "./Distortion.h"
@@ -31,6 +31,12 @@
 
 //==============================================================================
 
+// We include our SIMD biquad cascade, which runs both channels at once.
+#include "dsp/filter/BiquadCascade.h"
+
+// We include the parameter handles, so we don't look parameters up by name.
+#include "model/LowpassParameters.h"
+
 // We include the JUCE header to gain access to the JUCE framework.
 #include <JuceHeader.h>
 
@@ -73,8 +79,7 @@ class alignas(64) LowpassProcessor
   // This makes for cleaner and more readable code.
   using AudioBuffer = juce::AudioBuffer<float>;
   using AudioProcessorValueTreeState = juce::AudioProcessorValueTreeState;
-  using Filter = juce::IIRFilter;
-  using FilterArray = std::array<Filter, MAX_STAGES>;
+  using FilterCascade = dmt::dsp::filter::BiquadCascade<2, MAX_STAGES>;
 
 public:
   //============================================================================
@@ -115,6 +120,11 @@ public:
    */
   inline void prepare(const double _newSampleRate) noexcept
   {
+    // Looking a parameter up by its name means hashing a string, which is too
+    // slow for the audio thread. So we look them all up once here and keep
+    // handles to their values.
+    parameters.resolve(dmt::model::ParameterRegistry(apvts));
+
     // We store the sample rate in a class variable so we can use it later.
     sampleRate = _newSampleRate;
 
@@ -146,18 +156,19 @@ public:
       return; // Exit the function early.
     }
 
-    // We need to load the parameters from the AudioProcessorValueTreeState
+    // The filter cascade doesn't flush tiny values to zero by itself.
+    // Denormal numbers are extremely slow on most CPUs, so we disable them
+    // for the duration of this function.
+    juce::ScopedNoDenormals noDenormals;
+
+    // We need to load the parameters through the handles we got in prepare().
     // We load the parameters into local variables so we can compare them
     // against the previous values and see if they have changed.
     // We also use clamp() to ensure the values stay within the valid range.
     const int newStages =
-      std::clamp((int)apvts.getRawParameterValue("LowpassStages")->load(),
-                 MIN_STAGES,
-                 MAX_STAGES);
+      std::clamp(parameters.stages.load(), MIN_STAGES, MAX_STAGES);
     const float newFrequency =
-      std::clamp((float)apvts.getRawParameterValue("LowPassFrequency")->load(),
-                 MIN_FREQUENCY,
-                 MAX_FREQUENCY);
+      std::clamp(parameters.frequency.load(), MIN_FREQUENCY, MAX_FREQUENCY);
 
     // Check if the amount of stages has changed.
     const bool stagesChanged = stages != newStages;
@@ -177,9 +188,9 @@ public:
       setCoefficients();
     }
 
-    // We load the mix parameter from the AudioProcessorValueTreeState.
+    // We load the mix parameter through its handle as well.
     // This one is irrelevant for the filter coefficients so we just save it.
-    mix = apvts.getRawParameterValue("LowpassMix")->load();
+    mix = parameters.mix.load();
 
     // Now we process the audio buffer with the low-pass filters.
     // We loop over each sample in the buffer and apply the filters.
@@ -191,14 +202,14 @@ public:
       const float rightDry = _buffer.getSample(1, sample);
 
       // For the wet signal we also start with the dry signal.
-      float left = leftDry;
-      float right = rightDry;
+      // We pack both channels into one frame so the cascade can process them
+      // together in a single SIMD register.
+      FilterCascade::Frame frame = { leftDry, rightDry };
 
-      // Now we loop over each filter stage and apply them to the audio.
-      for (size_t filterIndex = 0; filterIndex < stages; ++filterIndex) {
-        left = leftFilters[filterIndex].processSingleSampleRaw(left);
-        right = rightFilters[filterIndex].processSingleSampleRaw(right);
-      }
+      // Now we run the frame through all active filter stages.
+      filters.processFrame(frame, static_cast<size_t>(stages));
+      float left = frame[0];
+      float right = frame[1];
 
       // Now calculate the wet and dry gain
       const float wetGain = mix;
@@ -230,9 +241,9 @@ protected:
     const auto coefficients =
       juce::IIRCoefficients::makeAllPass(sampleRate, frequency);
 
+    // Both channels share the same coefficients, so we set them only once.
     for (size_t filterIndex = 0; filterIndex < MAX_STAGES; ++filterIndex) {
-      leftFilters[filterIndex].setCoefficients(coefficients);
-      rightFilters[filterIndex].setCoefficients(coefficients);
+      filters.setCoefficients(filterIndex, coefficients);
     }
   }
 
@@ -242,6 +253,9 @@ private:
   // A reference (indicated by &) to the APVTS of the plugin.
   AudioProcessorValueTreeState& apvts;
 
+  // Handles to the values of our parameters, resolved in prepare().
+  dmt::model::LowpassParameterHandles parameters;
+
   // Tracks the sample rate of the audio.
   // We start with -1.0f to indicate that the sample rate is not set yet.
   double sampleRate = -1.0f;
@@ -258,10 +272,9 @@ private:
   // This will determine the slope of the filter.
   int stages = 1;
 
-  // Our series of filters for the left and right channels.
+  // Our series of filters, shared by the left and right channels.
   // They do the actual filtering of the audio.
-  FilterArray leftFilters;
-  FilterArray rightFilters;
+  FilterCascade filters;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LowpassProcessor)
 };
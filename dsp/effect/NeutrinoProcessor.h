@@ -30,9 +30,15 @@
 
 //==============================================================================
 
-#include "dsp/synth/NeutrinoSynthVoice.h"
-#include "dsp/synth/SynthSound.h"
+#include "dsp/data/EventQueue.h"
+#include "dsp/envelope/AdhEnvelope.h"
+#include "dsp/envelope/ControlRateModulator.h"
+#include "dsp/synth/DigitalOscillator.h"
+#include "dsp/synth/VoiceManager.h"
+#include "model/NeutrinoParameters.h"
+#include "utility/FastMath.h"
 #include <JuceHeader.h>
+#include <array>
 #include <utility/Settings.h>
 
 namespace dmt {
@@ -45,22 +51,43 @@ namespace effect {
  * @brief Neutrino Processor
  *
  * This class processes audio buffers to generate a kick drum sound.
+ *
+ * Voices come from a fixed pool. All voices share the oscillator shape and
+ * the envelope parameters, so a voice is just a lane of phase, envelope
+ * index and note frequency in the VoiceManager, and all lanes are rendered
+ * together in one vectorized loop.
+ *
+ * Note-ons are reported through an event queue that the GUI drains on its
+ * frame tick, so the audio thread never runs GUI code.
  */
 class alignas(64) NeutrinoProcessor
 {
   constexpr static float MIN_FREQUENCY = 20.0f;
   constexpr static float MAX_FREQUENCY = 20000.0f;
+  constexpr static float twoPi = juce::MathConstants<float>::twoPi;
+
+  // Size of the voice pool
+  static constexpr int maxVoices = 8;
+
+  // Number of samples all voices render at once
+  static constexpr int chunkSize = 64;
 
   using AudioBuffer = juce::AudioBuffer<float>;
-  using SynthVoice = dmt::dsp::synth::NeutrinoSynthVoice;
-  using SynthSound = dmt::dsp::synth::SynthSound;
+  using AhdEnvelope = dmt::dsp::envelope::AhdEnvelope;
+  using ControlRateModulator = dmt::dsp::envelope::ControlRateModulator;
+  using DigitalOscillator = dmt::dsp::synth::DigitalOscillator;
+  using Voices = dmt::dsp::synth::VoiceManager<maxVoices>;
 
 public:
+  using StealingPolicy = Voices::StealingPolicy;
+  using EventQueue = dmt::dsp::data::EventQueue<>;
+  using Event = dmt::dsp::data::ProcessorEvent;
+
   NeutrinoProcessor(juce::AudioProcessorValueTreeState& _apvts)
     : apvts(_apvts)
   {
-    synth.addSound(new SynthSound());
-    synth.addVoice(new SynthVoice(apvts));
+    // A new kick cuts the one before, like the single voice always did
+    voices.setPolyphony(1);
   }
 
   //==============================================================================
@@ -70,18 +97,64 @@ public:
    * @param _newSampleRate The sample rate.
    */
   inline void prepare(const double _newSampleRate,
-                      const int _samplesPerBlock) noexcept
+                      const int /*_samplesPerBlock*/) noexcept
   {
     sampleRate = static_cast<float>(_newSampleRate);
 
-    synth.setCurrentPlaybackSampleRate(sampleRate);
+    parameters.resolve(dmt::model::ParameterRegistry(apvts));
+    // The oscillator builds its first table for the loaded parameters
+    updateParameters();
 
-    for (int i = 0; i < synth.getNumVoices(); i++) {
-      auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i));
-      voice->prepareToPlay(sampleRate, _samplesPerBlock, 2);
-    }
+    gainEnvelope.setSampleRate(sampleRate);
+    pitchEnvelope1.setSampleRate(sampleRate);
+    pitchEnvelope2.setSampleRate(sampleRate);
+    osc.setSampleRate(sampleRate);
+    voices.reset();
+
+    // Reported by the audio thread, the queue only takes one producer
+    sampleClock = 0;
+    resetPending = true;
   }
 
+  //==============================================================================
+  /**
+   * @brief Sets how many kicks can ring at once.
+   * @param _polyphony The number of voices, up to the size of the pool.
+   */
+  inline void setPolyphony(const int _polyphony) noexcept
+  {
+    voices.setPolyphony(_polyphony);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets which voice a new kick takes when all voices are playing.
+   */
+  inline void setStealingPolicy(const StealingPolicy _policy) noexcept
+  {
+    voices.setStealingPolicy(_policy);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets whether the pitch envelopes run at audio or control rate.
+   */
+  inline void setModulationQuality(
+    const ControlRateModulator::Quality _quality) noexcept
+  {
+    pitchModulator.setQuality(_quality);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets the number of samples between two pitch evaluations.
+   */
+  inline void setControlInterval(const int _interval) noexcept
+  {
+    pitchModulator.setInterval(_interval);
+  }
+
+  //==============================================================================
   inline void processBlock(AudioBuffer& _buffer,
                            juce::MidiBuffer& _midiMessages) noexcept
   {
@@ -89,13 +162,214 @@ public:
       return;
     }
 
-    synth.renderNextBlock(_buffer, _midiMessages, 0, _buffer.getNumSamples());
+    if (resetPending) {
+      events.push({ Event::Type::Reset, sampleClock });
+      resetPending = false;
+    }
+
+    updateParameters();
+
+    // Notes start exactly at their sample, like in juce::Synthesiser
+    const int numSamples = _buffer.getNumSamples();
+    int position = 0;
+    for (const auto metadata : _midiMessages) {
+      const int eventPosition =
+        juce::jlimit(position, numSamples, metadata.samplePosition);
+      renderVoices(_buffer, position, eventPosition - position);
+      position = eventPosition;
+
+      const auto message = metadata.getMessage();
+      if (message.isNoteOn()) {
+        startNote(
+          message.getNoteNumber(), message.getFloatVelocity(), position);
+      }
+    }
+    renderVoices(_buffer, position, numSamples - position);
+
+    sampleClock += numSamples;
   }
 
+  //==============================================================================
+  /**
+   * @brief Gets the queue of note-on and reset events for the GUI.
+   *
+   * @details
+   * The GUI is the only consumer and should drain it on its frame tick, e.g.
+   * by handing it to OscilloscopeDisplay::setEventQueue().
+   */
+  [[nodiscard]] inline EventQueue& getEventQueue() noexcept { return events; }
+
 private:
   //==============================================================================
-  juce::Synthesiser synth;
+  /**
+   * @brief Loads the shared envelope and oscillator parameters.
+   */
+  inline void updateParameters() noexcept
+  {
+    gainEnvelope.setParameters(parameters.gainEnvelope);
+    pitchEnvelope1.setParameters(parameters.pitchEnvelope1);
+    pitchEnvelope2.setParameters(parameters.pitchEnvelope2);
+    osc.setParameters(parameters.oscillator);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Starts a kick on a free or stolen voice.
+   * @param _note The MIDI note number.
+   * @param _velocity The velocity of the note.
+   * @param _position The sample of the block the note starts at.
+   */
+  inline void startNote(const int _note,
+                        const float _velocity,
+                        const int _position) noexcept
+  {
+    // The oscillator plays one octave below the note
+    const int baseNote = _note - 12;
+    const auto baseFrequency =
+      static_cast<float>(juce::MidiMessage::getMidiNoteInHertz(baseNote));
+    voices.noteOn(_note, baseFrequency, _velocity);
+
+    events.push(
+      { Event::Type::NoteOn, sampleClock + _position, _note, _velocity });
+  }
+
+  //==============================================================================
+  /**
+   * @brief Adds all voices to a range of the buffer.
+   *
+   * @details
+   * Every stage loops over the frames of a chunk and, inside, over the voice
+   * lanes, which are independent of each other. Free lanes are rendered too
+   * and muted by their gate, so nothing branches on the voice state. The
+   * gain envelope of each voice is scaled by the velocity of its note.
+   *
+   * A voice is freed after the chunk in which its gain envelope runs out, and
+   * once no voice is left the rest of the range is skipped.
+   */
+  inline void renderVoices(AudioBuffer& _buffer,
+                           const int _startSample,
+                           const int _numSamples) noexcept
+  {
+    // Nothing is sounding, so the pool costs nothing until the next note
+    if (_numSamples <= 0 || !voices.isAnyActive())
+      return;
+
+    using dmt::math::branchlessClamp;
+    using dmt::math::branchlessSelect;
+
+    const auto pitchKernel1 = pitchEnvelope1.getKernel();
+    const auto pitchKernel2 = pitchEnvelope2.getKernel();
+
+    // mapToLog10() between the frequency limits, as an exponential
+    const float logRange = std::log(MAX_FREQUENCY / MIN_FREQUENCY);
+    const float pitchScale1 = pitchEnvelope1.getParameters().depth * logRange;
+    const float pitchScale2 = pitchEnvelope2.getParameters().depth * logRange;
+    const float phaseScale = twoPi / sampleRate;
+    const auto envelopeLength = static_cast<float>(gainEnvelope.getLength());
+
+    auto& phases = voices.getPhases();
+    auto& envelopeIndices = voices.getEnvelopeIndices();
+    auto& levels = voices.getLevels();
+    const auto& frequencies = voices.getFrequencies();
+    const auto& gates = voices.getGates();
+    const auto& velocities = voices.getVelocities();
+
+    // Voices past the polyphony are always free, so they are left out
+    const int numLanes = voices.getPolyphony();
+
+    alignas(64) std::array<float, chunkSize * maxVoices> laneGains;
+    alignas(64) std::array<float, chunkSize * maxVoices> laneFrequencies;
+    alignas(64) std::array<float, chunkSize * maxVoices> lanePhases;
+    alignas(64) std::array<float, chunkSize * maxVoices> laneSamples;
+
+    auto* leftChannel = _buffer.getWritePointer(0, _startSample);
+    auto* rightChannel = _buffer.getWritePointer(1, _startSample);
+
+    for (int start = 0; start < _numSamples; start += chunkSize) {
+      const int numFrames = std::min(chunkSize, _numSamples - start);
+      const int numValues = numFrames * numLanes;
+
+      for (int voice = 0; voice < numLanes; ++voice) {
+        gainEnvelope.renderFrom(laneGains.data() + voice,
+                                numFrames,
+                                static_cast<size_t>(envelopeIndices[voice]),
+                                numLanes);
+      }
+      for (int frame = 0; frame < numFrames; ++frame) {
+        float* gains = laneGains.data() + frame * numLanes;
+        for (int voice = 0; voice < numLanes; ++voice) {
+          gains[voice] *= gates[voice] * velocities[voice];
+        }
+      }
+
+      pitchModulator.renderLanes<maxVoices>(
+        laneFrequencies.data(),
+        numFrames,
+        numLanes,
+        envelopeIndices.data(),
+        [&](const int _voice, const float _index) {
+          const float pitch1 =
+            dmt::math::fastExp(pitchKernel1.getValue(_index) * pitchScale1);
+          const float pitch2 =
+            dmt::math::fastExp(pitchKernel2.getValue(_index) * pitchScale2);
+          const float frequency =
+            frequencies[_voice] + MIN_FREQUENCY * (pitch1 + pitch2);
+          return branchlessClamp(frequency, MIN_FREQUENCY, MAX_FREQUENCY);
+        });
+
+      for (int frame = 0; frame < numFrames; ++frame) {
+        const float* laneFrequency = laneFrequencies.data() + frame * numLanes;
+        float* framePhases = lanePhases.data() + frame * numLanes;
+        for (int voice = 0; voice < numLanes; ++voice) {
+          float phase = phases[voice] + laneFrequency[voice] * phaseScale;
+          phase -= branchlessSelect(phase >= twoPi, twoPi, 0.0f);
+          phases[voice] = phase;
+          framePhases[voice] = phase;
+        }
+      }
+
+      const float highestFrequency =
+        *std::max_element(laneFrequencies.data(),
+                          laneFrequencies.data() + numValues);
+      osc.renderPhases(
+        laneSamples.data(), lanePhases.data(), numValues, highestFrequency);
+
+      for (int frame = 0; frame < numFrames; ++frame) {
+        const float* samples = laneSamples.data() + frame * numLanes;
+        const float* gains = laneGains.data() + frame * numLanes;
+        float sum = 0.0f;
+        for (int voice = 0; voice < numLanes; ++voice) {
+          sum += samples[voice] * gains[voice];
+        }
+        leftChannel[start + frame] += sum;
+        rightChannel[start + frame] += sum;
+      }
+
+      // Free lanes keep their index, so they stay exact while unused
+      const float* lastGains = laneGains.data() + (numFrames - 1) * numLanes;
+      for (int voice = 0; voice < numLanes; ++voice) {
+        envelopeIndices[voice] += static_cast<float>(numFrames) * gates[voice];
+        levels[voice] = lastGains[voice];
+      }
+
+      voices.releaseFinished(envelopeLength);
+      if (!voices.isAnyActive())
+        return;
+    }
+  }
+
+  //==============================================================================
   juce::AudioProcessorValueTreeState& apvts;
+  dmt::model::NeutrinoParameterHandles parameters;
+  Voices voices;
+  DigitalOscillator osc;
+  AhdEnvelope gainEnvelope;
+  AhdEnvelope pitchEnvelope1;
+  AhdEnvelope pitchEnvelope2;
+  ControlRateModulator pitchModulator;
+  EventQueue events;
+  bool resetPending = false;
+  std::int64_t sampleClock = 0;
   float sampleRate = -1.0f;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NeutrinoProcessor)
@@ -104,4 +378,4 @@ private:
 //==============================================================================
 } // namespace effect
 } // namespace dsp
-} // namespace dmt
\ No newline at end of file
+} // namespace dmt
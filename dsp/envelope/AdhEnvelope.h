@@ -29,6 +29,8 @@
 
 //==============================================================================
 
+#include "model/AhdEnvelopeParameters.h"
+#include "utility/FastMath.h"
 #include "utility/Math.h"
 
 //==============================================================================
@@ -44,6 +46,12 @@ namespace envelope {
  *
  * This class generates an Attack-Hold-Decay (AHD) envelope.
  * It is optimized for real-time performance.
+ *
+ * The segment boundaries and the bend curves are computed when the
+ * parameters or the sample rate change. Each bend curve is kept as a lookup
+ * table that is only rebuilt when its bend changes, and renderBlock() fills
+ * whole runs of a segment at once, so a rendered sample costs an add and an
+ * interpolated table read.
  */
 class AhdEnvelope
 {
@@ -70,18 +78,21 @@ public:
 
   AhdEnvelope() noexcept = default;
 
-  inline void setParameters(const juce::AudioProcessorValueTreeState& apvts,
-                            juce::String prefix) noexcept
+  /**
+   * @brief Load the envelope parameters through resolved handles.
+   * @param _handles Handles to the parameters of this envelope.
+   */
+  inline void setParameters(
+    const dmt::model::EnvelopeParameterHandles& _handles) noexcept
   {
-    juce::String base = prefix + "Env";
-    params.enabled =
-      apvts.getRawParameterValue(base + "Enabled")->load() > 0.5f;
-    params.attack = apvts.getRawParameterValue(base + "Attack")->load();
-    params.hold = apvts.getRawParameterValue(base + "Hold")->load();
-    params.decay = apvts.getRawParameterValue(base + "Decay")->load();
-    params.attackBend = apvts.getRawParameterValue(base + "AttackBend")->load();
-    params.decayBend = apvts.getRawParameterValue(base + "DecayBend")->load();
-    params.depth = apvts.getRawParameterValue(base + "Depth")->load();
+    params.enabled = _handles.enabled.load();
+    params.attack = _handles.attack.load();
+    params.hold = _handles.hold.load();
+    params.decay = _handles.decay.load();
+    params.attackBend = _handles.attackBend.load();
+    params.decayBend = _handles.decayBend.load();
+    params.depth = _handles.depth.load();
+    updateSegments();
   }
 
   /**
@@ -91,6 +102,7 @@ public:
   inline void setParameters(const Parameters& _newParams) noexcept
   {
     params = _newParams;
+    updateSegments();
   }
 
   /**
@@ -107,6 +119,7 @@ public:
   inline void setSampleRate(const float _newSampleRate) noexcept
   {
     sampleRate = _newSampleRate;
+    updateSegments();
   }
 
   /**
@@ -114,6 +127,45 @@ public:
    */
   inline void noteOn() noexcept { sampleIndex = 0; }
 
+  /**
+   * @brief Get the number of samples since the envelope was triggered.
+   * @return The index of the next sample.
+   */
+  [[nodiscard]] inline size_t getSampleIndex() const noexcept
+  {
+    return sampleIndex;
+  }
+
+  /**
+   * @brief Move the envelope forward without evaluating it.
+   * @param _numSamples The number of samples to skip.
+   */
+  inline void skip(const size_t _numSamples) noexcept
+  {
+    sampleIndex += _numSamples;
+  }
+
+  /**
+   * @brief Get the number of samples after noteOn() until the envelope is idle.
+   * @return The length, or 0 if the envelope is disabled.
+   */
+  [[nodiscard]] inline size_t getLength() const noexcept
+  {
+    if (!params.enabled)
+      return 0;
+    // A decay shorter than a sample ends with the hold phase
+    return std::max(decayStart, decayEnd);
+  }
+
+  /**
+   * @brief Check if the envelope has finished and only outputs silence.
+   * @return True once the envelope is idle or if it is disabled.
+   */
+  [[nodiscard]] inline bool isIdle() const noexcept
+  {
+    return sampleIndex >= getLength();
+  }
+
   /**
    * @brief Get the current state of the envelope.
    * @return The current state.
@@ -143,6 +195,152 @@ public:
     return result;
   }
 
+  /**
+   * @brief Render the next block of the envelope.
+   * @param _output The buffer the envelope is written to.
+   * @param _numSamples The number of samples.
+   */
+  inline void renderBlock(float* _output, const int _numSamples) noexcept
+  {
+    renderFrom(_output, _numSamples, sampleIndex);
+    sampleIndex += static_cast<size_t>(_numSamples);
+  }
+
+  /**
+   * @brief Render a block of the envelope starting at any index.
+   * @param _output The buffer the envelope is written to.
+   * @param _numSamples The number of samples.
+   * @param _startIndex The number of samples since noteOn() of the first one.
+   * @param _stride The distance between two samples in the buffer.
+   *
+   * @details
+   * Doesn't change the envelope, so voices sharing one set of parameters can
+   * all be rendered from it, e.g. into interleaved lanes.
+   */
+  inline void renderFrom(float* _output,
+                         const int _numSamples,
+                         const size_t _startIndex,
+                         const int _stride = 1) const noexcept
+  {
+    size_t index = _startIndex;
+    int position = 0;
+
+    auto fill = [&](const int _length, auto&& _value) {
+      for (int i = 0; i < _length; ++i) {
+        _output[(position + i) * _stride] = _value(i);
+      }
+      position += _length;
+      index += static_cast<size_t>(_length);
+    };
+
+    auto lengthUntil = [&](const size_t _end) {
+      const size_t remaining = static_cast<size_t>(_numSamples - position);
+      return static_cast<int>(std::min(_end - index, remaining));
+    };
+
+    if (!params.enabled) {
+      fill(_numSamples, [](int) { return 0.0f; });
+      return;
+    }
+
+    while (position < _numSamples) {
+      if (index < holdStart) {
+        const float start = static_cast<float>(index) * attackStep;
+        fill(lengthUntil(holdStart), [&](const int _i) {
+          const float x = start + static_cast<float>(_i) * attackStep;
+          return attackCurve.lookup(x);
+        });
+      } else if (index < decayStart) {
+        fill(lengthUntil(decayStart), [](int) { return 1.0f; });
+      } else if (index < decayEnd) {
+        const float start = static_cast<float>(index - decayStart) * decayStep;
+        fill(lengthUntil(decayEnd), [&](const int _i) {
+          const float x = start + static_cast<float>(_i) * decayStep;
+          return 1.0f - decayCurve.lookup(x);
+        });
+      } else {
+        fill(_numSamples - position, [](int) { return 0.0f; });
+      }
+    }
+  }
+
+  /**
+   * @brief The envelope shape as a branch-free function of the sample index.
+   *
+   * Evaluates the same curve as getNextSample(), but for any index at once,
+   * so many voices sharing one set of parameters can be evaluated in a single
+   * vectorized loop. Indices are floats, so they are exact for envelopes of
+   * up to 2^24 samples.
+   */
+  struct Kernel
+  {
+    struct Bend
+    {
+      float k = 0.0f;
+      float inverseNormalizer = 1.0f;
+      bool isLinear = true;
+      bool isNegative = false;
+
+      /** Branch-free applyAtanBend() for a precomputed bend. */
+      [[nodiscard]] forcedinline float apply(const float _x) const noexcept
+      {
+        using dmt::math::branchlessSelect;
+        const float x = dmt::math::branchlessClamp(_x, 0.0f, 1.0f);
+        const float t = branchlessSelect(isNegative, 1.0f - x, x);
+        const float curve = dmt::math::fastAtan(k * t) * inverseNormalizer;
+        const float bent = branchlessSelect(isNegative, 1.0f - curve, curve);
+        return branchlessSelect(isLinear, x, bent);
+      }
+    };
+
+    float gain = 0.0f;
+    float holdStart = 0.0f;
+    float decayStart = 0.0f;
+    float decayEnd = 0.0f;
+    float attackScale = 0.0f;
+    float decayScale = 0.0f;
+    Bend attackBend;
+    Bend decayBend;
+
+    /**
+     * @brief Get the value of the envelope at a sample index.
+     * @param _index The number of samples since noteOn().
+     * @return The value of the envelope.
+     */
+    [[nodiscard]] forcedinline float getValue(const float _index) const noexcept
+    {
+      using dmt::math::branchlessSelect;
+      const float attack = attackBend.apply(_index * attackScale);
+      const float decay =
+        1.0f - decayBend.apply((_index - decayStart) * decayScale);
+      const float value = branchlessSelect(
+        _index < holdStart,
+        attack,
+        branchlessSelect(_index < decayStart,
+                         1.0f,
+                         branchlessSelect(_index < decayEnd, decay, 0.0f)));
+      return value * gain;
+    }
+  };
+
+  /**
+   * @brief Get the branch-free kernel for the current parameters.
+   * @return The kernel.
+   */
+  [[nodiscard]] inline Kernel getKernel() const noexcept
+  {
+    Kernel kernel;
+    kernel.gain = params.enabled ? 1.0f : 0.0f;
+    kernel.holdStart = static_cast<float>(getHoldStart());
+    kernel.decayStart = static_cast<float>(getDecayStart());
+    kernel.decayEnd = static_cast<float>(getDecayEnd());
+    kernel.attackScale = 1.0f / std::max(params.attack * sampleRate, 1.0f);
+    kernel.decayScale = 1.0f / std::max(params.decay * sampleRate, 1.0f);
+    kernel.attackBend = getBendKernel(params.attackBend);
+    kernel.decayBend = getBendKernel(params.decayBend);
+    return kernel;
+  }
+
 private:
   /**
    * @brief Get the value of the envelope based on its state.
@@ -158,19 +356,16 @@ private:
       case State::Disabled:
         return 0.0f;
       case State::Attack: {
-        const float normalizedPosition =
-          static_cast<float>(sampleIndex) / sampleRate;
-        const float phaseProgress = normalizedPosition / params.attack;
-        return applyAtanBend(phaseProgress, params.attackBend);
+        const float phaseProgress =
+          static_cast<float>(sampleIndex) * attackStep;
+        return attackCurve.lookup(phaseProgress);
       }
       case State::Hold:
         return one;
       case State::Decay: {
-        const float decayStart = static_cast<float>(getDecayStart());
-        const float normalizedPosition =
-          (static_cast<float>(sampleIndex) - decayStart) / sampleRate;
-        const float phaseProgress = normalizedPosition / params.decay;
-        return one - applyAtanBend(phaseProgress, params.decayBend);
+        const float phaseProgress =
+          static_cast<float>(sampleIndex - decayStart) * decayStep;
+        return one - decayCurve.lookup(phaseProgress);
       }
       default:
         return zero;
@@ -203,13 +398,104 @@ private:
     return 1.0f - (atan(k * (1.0f - x)) / normalizer);
   }
 
+  /**
+   * @brief Precompute the constants of applyAtanBend() for a bend.
+   */
+  [[nodiscard]] static inline Kernel::Bend getBendKernel(float bend) noexcept
+  {
+    Kernel::Bend kernel;
+    kernel.k = std::pow(0.5f * std::abs(bend), 2.0f);
+    kernel.isLinear = kernel.k <= 0.01f;
+    kernel.isNegative = bend <= 0.0f;
+    if (!kernel.isLinear)
+      kernel.inverseNormalizer = 1.0f / std::atan(kernel.k);
+    return kernel;
+  }
+
+  /**
+   * @brief applyAtanBend() of one bend, sampled over [0, 1].
+   *
+   * @details
+   * The bend is quantized to steps of resolution, the interval of the bend
+   * parameters, so a modulated bend only rebuilds the table once it moved a
+   * whole step.
+   */
+  class BendCurve
+  {
+  public:
+    static constexpr int size = 1024;
+    static constexpr float resolution = 0.1f;
+
+    /**
+     * @brief Rebuild the table, unless it already holds this bend step.
+     */
+    inline void update(const float _bend) noexcept
+    {
+      const int newStep = static_cast<int>(std::round(_bend / resolution));
+      if (hasStep && newStep == step)
+        return;
+
+      step = newStep;
+      hasStep = true;
+      const float bend = static_cast<float>(step) * resolution;
+      for (int i = 0; i <= size; ++i) {
+        const float x = static_cast<float>(i) / static_cast<float>(size);
+        values[static_cast<size_t>(i)] = applyAtanBend(x, bend);
+      }
+    }
+
+    /**
+     * @brief Read the curve with linear interpolation.
+     * @param _x The position, clamped to [0, 1].
+     */
+    [[nodiscard]] forcedinline float lookup(const float _x) const noexcept
+    {
+      const float position =
+        dmt::math::branchlessClamp(_x, 0.0f, 1.0f) * static_cast<float>(size);
+      const int index = std::min(static_cast<int>(position), size - 1);
+      const float fraction = position - static_cast<float>(index);
+      const float current = values[static_cast<size_t>(index)];
+      const float next = values[static_cast<size_t>(index + 1)];
+      return current + fraction * (next - current);
+    }
+
+  private:
+    int step = 0;
+    bool hasStep = false;
+    std::array<float, size + 1> values{};
+  };
+
+  /**
+   * @brief Precompute the segment boundaries and the bend curves.
+   */
+  inline void updateSegments() noexcept
+  {
+    attackCurve.update(params.attackBend);
+    decayCurve.update(params.decayBend);
+
+    // Not prepared yet, setSampleRate() will come back here
+    if (sampleRate <= 0.0f)
+      return;
+
+    const float rawDecayDelay = params.attack + params.hold;
+    const float rawDecayEnd = params.attack + params.hold + params.decay;
+    holdStart = static_cast<size_t>(params.attack * sampleRate);
+    decayStart = static_cast<size_t>(rawDecayDelay * sampleRate) + 1;
+    decayEnd = static_cast<size_t>(rawDecayEnd * sampleRate);
+
+    const float attackSamples = params.attack * sampleRate;
+    const float decaySamples = params.decay * sampleRate;
+    attackStep = attackSamples > 0.0f ? 1.0f / attackSamples : 0.0f;
+    decayStep = decaySamples > 0.0f ? 1.0f / decaySamples : 0.0f;
+  }
+
   /**
    * @brief Get the sample index where the hold phase starts.
    * @return The sample index.
    */
   [[nodiscard]] inline size_t getHoldStart() const noexcept
   {
-    return static_cast<size_t>(params.attack * sampleRate);
+    return holdStart;
   }
 
   /**
@@ -218,24 +504,27 @@ private:
    */
   [[nodiscard]] inline size_t getDecayStart() const noexcept
   {
-    const float rawDecayDelay = params.attack + params.hold;
-    return static_cast<size_t>(rawDecayDelay * sampleRate) + 1;
+    return decayStart;
   }
 
   /**
    * @brief Get the sample index where the decay phase ends.
    * @return The sample index.
    */
-  [[nodiscard]] inline size_t getDecayEnd() const noexcept
-  {
-    const float rawDecayEnd = params.attack + params.hold + params.decay;
-    return static_cast<size_t>(rawDecayEnd * sampleRate);
-  }
+  [[nodiscard]] inline size_t getDecayEnd() const noexcept { return decayEnd; }
 
   float sampleRate = -1.0f;
   Parameters params;
   size_t sampleIndex = 0;
 
+  size_t holdStart = 0;
+  size_t decayStart = 0;
+  size_t decayEnd = 0;
+  float attackStep = 0.0f;
+  float decayStep = 0.0f;
+  BendCurve attackCurve;
+  BendCurve decayCurve;
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AhdEnvelope)
 };
 
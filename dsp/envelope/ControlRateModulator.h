@@ -0,0 +1,205 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Evaluates slow modulation at a control rate and interpolates it per sample.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace envelope {
+
+//==============================================================================
+/**
+ * @class ControlRateModulator
+ * @brief Renders modulation from a few evaluations per block.
+ *
+ * @details
+ * The modulation is a function of the envelope index, the number of samples
+ * since the note started. At audio rate it is evaluated for every sample.
+ * At control rate it is evaluated at the start of a block and then once per
+ * interval, and the samples in between are interpolated linearly. The
+ * interpolation is a plain ramp the compiler vectorizes, so a pitch sweep
+ * costs one evaluation per interval instead of one per sample.
+ */
+class alignas(64) ControlRateModulator
+{
+public:
+  enum class Quality
+  {
+    AudioRate,
+    ControlRate,
+  };
+
+  static constexpr int defaultInterval = 16;
+  static constexpr int maxInterval = 256;
+
+  ControlRateModulator() = default;
+
+  //==============================================================================
+  inline void setQuality(const Quality _quality) noexcept
+  {
+    quality = _quality;
+  }
+
+  [[nodiscard]] inline Quality getQuality() const noexcept { return quality; }
+
+  [[nodiscard]] inline bool isAudioRate() const noexcept
+  {
+    return quality == Quality::AudioRate || interval == 1;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets how many samples lie between two evaluations.
+   * @param _interval The interval, clamped to [1, maxInterval].
+   */
+  inline void setInterval(const int _interval) noexcept
+  {
+    interval = std::clamp(_interval, 1, maxInterval);
+  }
+
+  [[nodiscard]] inline int getInterval() const noexcept { return interval; }
+
+  //==============================================================================
+  /**
+   * @brief Renders the modulation for a block.
+   * @param _output The buffer the modulation is written to.
+   * @param _numSamples The number of samples.
+   * @param _startIndex The envelope index of the first sample.
+   * @param _modulation Callable returning the modulation at an envelope index.
+   */
+  template<typename ModulationFunction>
+  inline void render(float* _output,
+                     const int _numSamples,
+                     const float _startIndex,
+                     ModulationFunction&& _modulation) const noexcept
+  {
+    if (isAudioRate()) {
+      for (int i = 0; i < _numSamples; ++i) {
+        _output[i] = _modulation(_startIndex + static_cast<float>(i));
+      }
+      return;
+    }
+
+    float previous = _modulation(_startIndex);
+    for (int start = 0; start < _numSamples; start += interval) {
+      const int length = std::min(interval, _numSamples - start);
+      const float next =
+        _modulation(_startIndex + static_cast<float>(start + length));
+      const float step = (next - previous) / static_cast<float>(length);
+      for (int i = 0; i < length; ++i) {
+        _output[start + i] = previous + step * static_cast<float>(i);
+      }
+      previous = next;
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Renders the modulation of many voices, one lane per voice.
+   * @tparam MaxLanes The most lanes that are ever rendered.
+   * @param _output The buffer, frame after frame with one value per lane.
+   * @param _numFrames The number of frames.
+   * @param _numLanes The number of lanes.
+   * @param _startIndices The envelope index of the first frame of each lane.
+   * @param _modulation Callable returning the modulation of a lane at an
+   * envelope index.
+   *
+   * @details
+   * Evaluates all lanes of a control point in one loop, so the modulation
+   * function is vectorized across the voices.
+   */
+  template<int MaxLanes, typename ModulationFunction>
+  inline void renderLanes(float* _output,
+                          const int _numFrames,
+                          const int _numLanes,
+                          const float* _startIndices,
+                          ModulationFunction&& _modulation) const noexcept
+  {
+    jassert(_numLanes <= MaxLanes);
+
+    if (isAudioRate()) {
+      for (int frame = 0; frame < _numFrames; ++frame) {
+        const float offset = static_cast<float>(frame);
+        float* output = _output + frame * _numLanes;
+        for (int lane = 0; lane < _numLanes; ++lane) {
+          output[lane] = _modulation(lane, _startIndices[lane] + offset);
+        }
+      }
+      return;
+    }
+
+    alignas(64) std::array<float, MaxLanes> previous;
+    alignas(64) std::array<float, MaxLanes> next;
+    alignas(64) std::array<float, MaxLanes> step;
+
+    for (int lane = 0; lane < _numLanes; ++lane) {
+      previous[lane] = _modulation(lane, _startIndices[lane]);
+    }
+
+    for (int start = 0; start < _numFrames; start += interval) {
+      const int length = std::min(interval, _numFrames - start);
+      const float offset = static_cast<float>(start + length);
+      const float inverseLength = 1.0f / static_cast<float>(length);
+      for (int lane = 0; lane < _numLanes; ++lane) {
+        next[lane] = _modulation(lane, _startIndices[lane] + offset);
+        step[lane] = (next[lane] - previous[lane]) * inverseLength;
+      }
+
+      for (int i = 0; i < length; ++i) {
+        const float position = static_cast<float>(i);
+        float* output = _output + (start + i) * _numLanes;
+        for (int lane = 0; lane < _numLanes; ++lane) {
+          output[lane] = previous[lane] + step[lane] * position;
+        }
+      }
+
+      previous = next;
+    }
+  }
+
+private:
+  //==============================================================================
+  Quality quality = Quality::ControlRate;
+  int interval = defaultInterval;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ControlRateModulator)
+};
+
+//==============================================================================
+
+} // namespace envelope
+} // namespace dsp
+} // namespace dmt
+
+//==============================================================================
@@ -30,5 +30,6 @@
 //==============================================================================
 
 #include "./AdhEnvelope.h"
+#include "./ControlRateModulator.h"
 
 //==============================================================================
\ No newline at end of file
@@ -0,0 +1,437 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Applies a log-spaced allpass sweep as an FFT convolution. The impulse
+ * response is computed on a background thread, shared by all instances, and
+ * handed to juce::dsp::Convolution.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "dsp/filter/AllpassSweepGenerator.h"
+#include "dsp/filter/BiquadCascade.h"
+#include <JuceHeader.h>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace filter {
+
+//==============================================================================
+/**
+ * @brief Convolution engine for a static log-spaced allpass sweep.
+ *
+ * @details
+ * While its parameters are fixed, a cascade of allpass filters is just a
+ * linear filter. This class renders the impulse response of such a cascade
+ * and applies it with juce::dsp::Convolution, which uses uniformly
+ * partitioned FFT convolution with no added latency. The cost then depends
+ * on the length of the impulse response instead of on the number of stages.
+ *
+ * The impulse response is rendered on one background thread shared by every
+ * convolver in the process, see Worker. The stages are applied in passes of stagesPerPass, so sweeps can have far more stages
+ * than a BiquadCascade holds. The response is trimmed once less than
+ * tailEnergyThreshold of its energy is left. If that does not happen within
+ * the maximum length, the response is dropped and isReady() stays false. A
+ * sweep that reaches deep into the bass can ring for seconds, and the
+ * recursive cascade is cheaper for it anyway.
+ *
+ * The audio thread calls request() with the sweep it wants and polls
+ * isReadyFor(). Neither call blocks or allocates.
+ */
+class alignas(64) AllpassSweepConvolver
+{
+  using Cascade = BiquadCascade<1, 256>;
+  using AudioBuffer = juce::AudioBuffer<float>;
+  using Convolution = juce::dsp::Convolution;
+
+public:
+  /** Number of stages applied to the impulse per rendering pass. */
+  static constexpr int stagesPerPass = 256;
+
+  /** Fraction of the energy that may be cut off when trimming the tail. */
+  static constexpr float tailEnergyThreshold = 1.0e-7f;
+
+  //==============================================================================
+  /**
+   * @brief Describes a log-spaced allpass sweep.
+   */
+  struct Sweep
+  {
+    float startFrequency = 0.0f;
+    float endFrequency = 0.0f;
+    float q = 0.0f;
+    int numStages = 0;
+
+    bool operator==(const Sweep& _other) const noexcept = default;
+  };
+
+  //==============================================================================
+  /**
+   * @brief One rendering thread shared by every convolver in the process.
+   *
+   * @details
+   * Convolvers register in prepare() and request impulse responses from the
+   * audio thread. That only sets a flag, as notify() locks a mutex, and the
+   * worker polls it every pollInterval milliseconds. A pass serves every
+   * registered convolver under convolversLock, so once remove() returns the
+   * convolver is never touched again.
+   *
+   * Use it through juce::SharedResourcePointer, so the thread only exists
+   * while at least one convolver does.
+   */
+  class Worker : private juce::Thread
+  {
+  public:
+    Worker()
+      : Thread("AllpassSweepConvolver")
+    {
+      startThread();
+    }
+
+    ~Worker() override { stopThread(1000); }
+
+    using juce::Thread::threadShouldExit;
+
+  private:
+    friend class AllpassSweepConvolver;
+
+    //============================================================================
+    inline void add(AllpassSweepConvolver& _convolver)
+    {
+      const juce::ScopedLock lock(convolversLock);
+      convolvers.push_back(&_convolver);
+    }
+
+    //============================================================================
+    inline void remove(AllpassSweepConvolver& _convolver)
+    {
+      // Blocks for at most the impulse response being rendered
+      const juce::ScopedLock lock(convolversLock);
+      convolvers.erase(
+        std::remove(convolvers.begin(), convolvers.end(), &_convolver),
+        convolvers.end());
+    }
+
+    //============================================================================
+    inline void run() override
+    {
+      juce::ScopedNoDenormals noDenormals;
+
+      while (!threadShouldExit()) {
+        wait(pollInterval);
+        if (!workPending.exchange(false, std::memory_order_acq_rel))
+          continue;
+
+        const juce::ScopedLock lock(convolversLock);
+        for (auto* convolver : convolvers) {
+          if (threadShouldExit())
+            return;
+          convolver->serve(*this);
+        }
+      }
+    }
+
+    //============================================================================
+    // Milliseconds between two looks at workPending
+    static constexpr int pollInterval = 5;
+
+    juce::CriticalSection convolversLock;
+    std::vector<AllpassSweepConvolver*> convolvers;
+    std::atomic<bool> workPending{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+  };
+
+  //==============================================================================
+  /**
+   * @brief Constructs the convolver. It registers with the worker in
+   * prepare().
+   *
+   * @param _maxImpulseLength The longest impulse response to accept.
+   */
+  explicit AllpassSweepConvolver(const int _maxImpulseLength = 1 << 16)
+    : maxImpulseLength(_maxImpulseLength)
+  {
+  }
+
+  //==============================================================================
+  /**
+   * @brief Destructor. Waits for an impulse response in progress to finish.
+   */
+  inline ~AllpassSweepConvolver() noexcept { worker->remove(*this); }
+
+  //==============================================================================
+  /**
+   * @brief Prepares the convolution and registers with the worker.
+   *
+   * @param _sampleRate The sample rate.
+   * @param _maxBlockSize The largest block process() will be called with.
+   *
+   * @details
+   * Allocates, so it must not be called on the audio thread. Any loaded
+   * impulse response is discarded.
+   */
+  inline void prepare(const double _sampleRate, const int _maxBlockSize)
+  {
+    worker->remove(*this);
+
+    sampleRate = _sampleRate;
+    convolution.prepare({ _sampleRate,
+                          static_cast<juce::uint32>(_maxBlockSize),
+                          static_cast<juce::uint32>(2) });
+    convolution.reset();
+
+    requestedSweep = {};
+    requestedGeneration = 0;
+    pendingGeneration = 0;
+    servedGeneration = 0;
+    readyGeneration.store(0, std::memory_order_release);
+
+    worker->add(*this);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Asks for the impulse response of a sweep to be rendered.
+   *
+   * @param _sweep The sweep to render.
+   *
+   * @details
+   * Does nothing when the sweep is already the latest request. If the
+   * worker holds the lock, the request is dropped and the caller
+   * simply tries again on the next block, as isReadyFor() stays false.
+   */
+  inline void request(const Sweep& _sweep) noexcept
+  {
+    if (_sweep == requestedSweep)
+      return;
+
+    const juce::SpinLock::ScopedTryLockType lock(pendingLock);
+    if (!lock.isLocked())
+      return;
+
+    requestedSweep = _sweep;
+    pendingSweep = _sweep;
+    pendingGeneration = ++requestedGeneration;
+    worker->workPending.store(true, std::memory_order_release);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Checks if a sweep has been handed to the convolution.
+   *
+   * @param _sweep The sweep to check for.
+   * @return True if the sweep is the latest request and has been loaded.
+   *
+   * @details
+   * juce::dsp::Convolution switches to a new impulse response within the
+   * next few blocks and crossfades to it on its own.
+   */
+  [[nodiscard]] inline bool isReadyFor(const Sweep& _sweep) const noexcept
+  {
+    return requestedGeneration != 0 && _sweep == requestedSweep &&
+           readyGeneration.load(std::memory_order_acquire) ==
+             requestedGeneration;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Gets the length of the impulse response that was loaded last.
+   *
+   * @return The length in samples.
+   */
+  [[nodiscard]] inline int getImpulseLength() const noexcept
+  {
+    return impulseLength.load(std::memory_order_acquire);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Convolves the first samples of a stereo buffer in place.
+   *
+   * @param _buffer The buffer, with at least two channels.
+   * @param _numSamples The number of samples, at most the prepared block size.
+   */
+  inline void process(AudioBuffer& _buffer, const int _numSamples) noexcept
+  {
+    juce::dsp::AudioBlock<float> block(_buffer);
+    auto subBlock = block.getSubBlock(0, static_cast<size_t>(_numSamples));
+    convolution.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+  }
+
+  //==============================================================================
+  /**
+   * @brief Clears the convolution state, keeping the impulse response.
+   */
+  inline void reset() noexcept { convolution.reset(); }
+
+protected:
+  //==============================================================================
+  /**
+   * @brief Renders and loads the pending impulse response, if there is one.
+   *
+   * @param _worker The worker calling, checked for a pending exit.
+   */
+  inline void serve(const Worker& _worker)
+  {
+    Sweep sweep;
+    int generation = 0;
+    {
+      const juce::SpinLock::ScopedLockType lock(pendingLock);
+      if (servedGeneration == pendingGeneration)
+        return;
+      sweep = pendingSweep;
+      generation = pendingGeneration;
+      servedGeneration = generation;
+    }
+
+    AudioBuffer impulseResponse;
+    if (!renderImpulseResponse(_worker, sweep, impulseResponse))
+      return;
+
+    // Skip the load if a newer request came in while rendering
+    {
+      const juce::SpinLock::ScopedLockType lock(pendingLock);
+      if (pendingGeneration != generation)
+        return;
+    }
+
+    const int length = impulseResponse.getNumSamples();
+    convolution.loadImpulseResponse(std::move(impulseResponse),
+                                    sampleRate,
+                                    Convolution::Stereo::no,
+                                    Convolution::Trim::no,
+                                    Convolution::Normalise::no);
+    impulseLength.store(length, std::memory_order_release);
+    readyGeneration.store(generation, std::memory_order_release);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Renders the impulse response of a sweep.
+   *
+   * @param _worker The worker calling, checked for a pending exit.
+   * @param _sweep The sweep to render.
+   * @param _impulseResponse Receives the trimmed mono impulse response.
+   * @return False if the response did not decay within the maximum length.
+   */
+  inline bool renderImpulseResponse(const Worker& _worker,
+                                    const Sweep& _sweep,
+                                    AudioBuffer& _impulseResponse)
+  {
+    _impulseResponse.setSize(1, maxImpulseLength);
+    _impulseResponse.clear();
+    _impulseResponse.setSample(0, 0, 1.0f);
+    float* const channels[1] = { _impulseResponse.getWritePointer(0) };
+
+    // Clamp like AllpassSweepGenerator, then apply the sweep in slices. Every
+    // slice of a log-spaced sweep is itself log-spaced.
+    const auto fs = static_cast<float>(sampleRate);
+    const float maxFrequency = AllpassSweepGenerator::maxRelativeFrequency * fs;
+    const float logStart =
+      std::log(std::min(_sweep.startFrequency, maxFrequency));
+    const float logDelta =
+      std::log(std::min(_sweep.endFrequency, maxFrequency)) - logStart;
+    const auto frequencyAt = [&](const int _stage) {
+      const float position =
+        _sweep.numStages == 1
+          ? 0.5f
+          : static_cast<float>(_stage) /
+              static_cast<float>(_sweep.numStages - 1);
+      return std::exp(logStart + logDelta * position);
+    };
+
+    for (int first = 0; first < _sweep.numStages; first += stagesPerPass) {
+      if (_worker.threadShouldExit())
+        return false;
+
+      const int count = std::min(stagesPerPass, _sweep.numStages - first);
+      AllpassSweepGenerator::generate(passCascade.getCoefficients(),
+                                      static_cast<size_t>(count),
+                                      frequencyAt(first),
+                                      frequencyAt(first + count - 1),
+                                      _sweep.q,
+                                      fs);
+      passCascade.reset();
+      passCascade.processStageMajor(
+        channels, maxImpulseLength, static_cast<size_t>(count));
+    }
+
+    // Walk back from the end until the cut-off tail holds enough energy
+    const float* samples = channels[0];
+    float totalEnergy = 0.0f;
+    for (int i = 0; i < maxImpulseLength; ++i)
+      totalEnergy += samples[i] * samples[i];
+
+    const float allowedTailEnergy = tailEnergyThreshold * totalEnergy;
+    float tailEnergy = 0.0f;
+    int length = maxImpulseLength;
+    while (length > 1) {
+      const float sample = samples[length - 1];
+      if (tailEnergy + sample * sample > allowedTailEnergy)
+        break;
+      tailEnergy += sample * sample;
+      --length;
+    }
+
+    // A response that is still ringing at the very end was cut off
+    if (length > maxImpulseLength - maxImpulseLength / 8)
+      return false;
+
+    _impulseResponse.setSize(1, length, true);
+    return true;
+  }
+
+private:
+  //==============================================================================
+  const int maxImpulseLength;
+  double sampleRate = 44100.0;
+  Convolution convolution;
+  Cascade passCascade;
+
+  juce::SharedResourcePointer<Worker> worker;
+
+  // Request handoff between the audio thread and the worker
+  juce::SpinLock pendingLock;
+  Sweep pendingSweep;
+  int pendingGeneration = 0;
+  int servedGeneration = 0;
+  std::atomic<int> readyGeneration = 0;
+  std::atomic<int> impulseLength = 0;
+
+  // Only touched by the audio thread
+  Sweep requestedSweep;
+  int requestedGeneration = 0;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AllpassSweepConvolver)
+};
+
+//==============================================================================
+} // namespace filter
+} // namespace dsp
+} // namespace dmt
@@ -0,0 +1,144 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Batch generator for log-spaced allpass coefficients, written straight into
+ * the coefficient arrays of a BiquadCascade.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "utility/FastMath.h"
+#include <JuceHeader.h>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace filter {
+
+//==============================================================================
+
+/**
+ * @brief Computes allpass coefficients for a whole cascade in one pass.
+ *
+ * @details
+ * Produces the same coefficients as calling juce::IIRCoefficients::makeAllPass
+ * once per stage with log-spaced frequencies. All maths is done in float with
+ * dmt::math::fastExp and dmt::math::fastTan, and the inner loop has no
+ * branches and no calls, so the compiler can vectorize it over the stages.
+ *
+ * With K = tan(pi * f / fs) the normalised allpass is
+ *
+ *   b0 = a2 = (K^2 - K / Q + 1) / (K^2 + K / Q + 1)
+ *   b1 = a1 = 2 (K^2 - 1) / (K^2 + K / Q + 1)
+ *   b2 = 1
+ *
+ * Start and end frequency are clamped to 0.49 * fs before the loop, because K
+ * grows without bound as f approaches the Nyquist frequency. The stages lie
+ * between the two, so none of them can go past it either.
+ */
+struct AllpassSweepGenerator
+{
+  /** Highest frequency used, relative to the sample rate. */
+  static constexpr float maxRelativeFrequency = 0.49f;
+
+  //============================================================================
+  /**
+   * @brief Fills the first stages with log-spaced allpass coefficients.
+   *
+   * @tparam CoefficientsType The Coefficients struct of a BiquadCascade.
+   * @param _coefficients The arrays to write into.
+   * @param _numStages The number of stages to fill.
+   * @param _startFrequency Frequency of the first stage, in Hz.
+   * @param _endFrequency Frequency of the last stage, in Hz.
+   * @param _q The quality factor shared by all stages.
+   * @param _sampleRate The sample rate, in Hz.
+   *
+   * @details
+   * A single stage sits halfway between start and end in the log domain,
+   * the same way DisfluxProcessor has always placed it.
+   */
+  template<typename CoefficientsType>
+  static inline void generate(CoefficientsType& _coefficients,
+                              const size_t _numStages,
+                              const float _startFrequency,
+                              const float _endFrequency,
+                              const float _q,
+                              const float _sampleRate) noexcept
+  {
+    jassert(_numStages <= _coefficients.b0.size());
+    jassert(_startFrequency > 0.0f && _endFrequency > 0.0f);
+    jassert(_q > 0.0f && _sampleRate > 0.0f);
+
+    const int numStages =
+      static_cast<int>(std::min(_numStages, _coefficients.b0.size()));
+    if (numStages <= 0)
+      return;
+
+    const float maxFrequency = maxRelativeFrequency * _sampleRate;
+    const float logStart = std::log(std::min(_startFrequency, maxFrequency));
+    const float logEnd = std::log(std::min(_endFrequency, maxFrequency));
+    const float logDelta = logEnd - logStart;
+    const float positionScale =
+      numStages == 1 ? 0.0f : 1.0f / static_cast<float>(numStages - 1);
+    const float positionOffset = numStages == 1 ? 0.5f : 0.0f;
+
+    // Work on relative frequency, so the angle is just pi times it
+    const float logSampleRate = std::log(_sampleRate);
+    const float invQ = 1.0f / _q;
+
+    float* const b0 = _coefficients.b0.data();
+    float* const b1 = _coefficients.b1.data();
+    float* const b2 = _coefficients.b2.data();
+    float* const a1 = _coefficients.a1.data();
+    float* const a2 = _coefficients.a2.data();
+
+    for (int stage = 0; stage < numStages; ++stage) {
+      const float position =
+        static_cast<float>(stage) * positionScale + positionOffset;
+      const float relativeFrequency =
+        dmt::math::fastExp(logStart + logDelta * position - logSampleRate);
+
+      const float k = dmt::math::fastTan(juce::MathConstants<float>::pi *
+                                         relativeFrequency);
+      const float kSquared = k * k;
+      const float norm = 1.0f / (kSquared + k * invQ + 1.0f);
+      const float outer = (kSquared - k * invQ + 1.0f) * norm;
+      const float middle = 2.0f * (kSquared - 1.0f) * norm;
+
+      b0[stage] = outer;
+      b1[stage] = middle;
+      b2[stage] = 1.0f;
+      a1[stage] = middle;
+      a2[stage] = outer;
+    }
+  }
+};
+
+//==============================================================================
+} // namespace filter
+} // namespace dsp
+} // namespace dmt
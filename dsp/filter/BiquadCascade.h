@@ -0,0 +1,561 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * SIMD biquad cascade with structure-of-arrays coefficient and state
+ * storage. Processes several channels through a series of biquad stages in
+ * parallel, with all channels sharing one coefficient set per stage.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <JuceHeader.h>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace filter {
+
+//==============================================================================
+/**
+ * @brief Multichannel biquad cascade running all channels in SIMD lanes.
+ *
+ * @tparam NumChannels The number of channels processed in parallel.
+ * @tparam MaxStages The maximum number of biquad stages in the cascade.
+ *
+ * @details
+ * The channels of a frame are packed into the lanes of a
+ * juce::dsp::SIMDRegister, so a stereo signal travels through every stage in a
+ * single register. Wider layouts simply use more registers per stage.
+ *
+ * Coefficients are stored as one array per coefficient (b0, b1, b2, a1, a2)
+ * and are shared by all channels, as every user of this class runs the same
+ * filter on each channel. The filter state is stored per stage and register.
+ *
+ * Each stage uses the transposed direct form II with normalised coefficients,
+ * exactly like juce::IIRFilter, so juce::IIRCoefficients can be used as-is.
+ *
+ * Coefficients can also be ramped linearly from sample to sample. Fill the
+ * arrays returned by getRampTargets(), call startRamp() and use the *Ramped
+ * process functions for exactly as many samples as the ramp was started with.
+ *
+ * Unlike juce::IIRFilter, the state is not snapped to zero after each sample.
+ * Callers should disable denormals (e.g. with juce::ScopedNoDenormals) while
+ * processing.
+ */
+template<size_t NumChannels, size_t MaxStages>
+class alignas(64) BiquadCascade
+{
+  static_assert(NumChannels > 0, "BiquadCascade needs at least one channel.");
+  static_assert(MaxStages > 0, "BiquadCascade needs at least one stage.");
+
+  using SIMD = juce::dsp::SIMDRegister<float>;
+
+  static constexpr size_t laneCount = SIMD::SIMDNumElements;
+  static constexpr size_t registerCount =
+    (NumChannels + laneCount - 1) / laneCount;
+  static constexpr size_t paddedChannels = registerCount * laneCount;
+
+  using Registers = std::array<SIMD, registerCount>;
+  using States = std::array<Registers, MaxStages>;
+
+public:
+  //============================================================================
+  /** Number of frames processStageMajor() keeps in its scratch buffer. */
+  static constexpr int chunkSize = 64;
+
+  /** Number of stages processStageMajor() runs together over a chunk. */
+  static constexpr size_t stageGroupSize = 4;
+
+  //============================================================================
+  /**
+   * @brief Structure-of-arrays storage for the coefficients of all stages.
+   *
+   * @details
+   * Coefficients are normalised, so a0 is always one and not stored.
+   */
+  struct Coefficients
+  {
+    alignas(64) std::array<float, MaxStages> b0;
+    alignas(64) std::array<float, MaxStages> b1;
+    alignas(64) std::array<float, MaxStages> b2;
+    alignas(64) std::array<float, MaxStages> a1;
+    alignas(64) std::array<float, MaxStages> a2;
+  };
+
+  /** One sample for each channel. */
+  using Frame = std::array<float, NumChannels>;
+
+  //============================================================================
+  /**
+   * @brief Constructs a cascade with all stages set to pass-through.
+   */
+  BiquadCascade() noexcept
+  {
+    for (size_t stage = 0; stage < MaxStages; ++stage)
+      setCoefficients(stage, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+
+    reset();
+  }
+
+  //============================================================================
+  /**
+   * @brief Sets the coefficients of a single stage.
+   *
+   * @param _stage The index of the stage.
+   * @param _coefficients The coefficients, as used by juce::IIRFilter.
+   */
+  forcedinline void setCoefficients(
+    const size_t _stage,
+    const juce::IIRCoefficients& _coefficients) noexcept
+  {
+    setCoefficients(_stage,
+                    _coefficients.coefficients[0],
+                    _coefficients.coefficients[1],
+                    _coefficients.coefficients[2],
+                    _coefficients.coefficients[3],
+                    _coefficients.coefficients[4]);
+  }
+
+  //============================================================================
+  /**
+   * @brief Sets the normalised coefficients of a single stage.
+   *
+   * @param _stage The index of the stage.
+   * @param _b0 The first feed-forward coefficient.
+   * @param _b1 The second feed-forward coefficient.
+   * @param _b2 The third feed-forward coefficient.
+   * @param _a1 The first feedback coefficient.
+   * @param _a2 The second feedback coefficient.
+   */
+  forcedinline void setCoefficients(const size_t _stage,
+                                    const float _b0,
+                                    const float _b1,
+                                    const float _b2,
+                                    const float _a1,
+                                    const float _a2) noexcept
+  {
+    jassert(_stage < MaxStages);
+    coefficients.b0[_stage] = _b0;
+    coefficients.b1[_stage] = _b1;
+    coefficients.b2[_stage] = _b2;
+    coefficients.a1[_stage] = _a1;
+    coefficients.a2[_stage] = _a2;
+  }
+
+  //============================================================================
+  /**
+   * @brief Gives direct access to the coefficient arrays.
+   *
+   * @return A reference to the coefficients of all stages.
+   */
+  [[nodiscard]] forcedinline Coefficients& getCoefficients() noexcept
+  {
+    return coefficients;
+  }
+
+  //============================================================================
+  /**
+   * @brief Gives access to the coefficients the next ramp will move towards.
+   *
+   * @return A reference to the ramp target coefficients of all stages.
+   */
+  [[nodiscard]] forcedinline Coefficients& getRampTargets() noexcept
+  {
+    return rampTargets;
+  }
+
+  //============================================================================
+  /**
+   * @brief Starts a linear ramp from the current to the target coefficients.
+   *
+   * @param _numStages The number of stages to ramp, starting at the first.
+   * @param _numSamples The number of samples the ramp takes.
+   *
+   * @details
+   * Every ramped sample adds one step to each coefficient, so after
+   * _numSamples samples the coefficients reach the targets up to float
+   * rounding. Call jumpToRampTargets() afterwards to land on them exactly.
+   *
+   * The region of stable (a1, a2) pairs is a triangle and therefore convex,
+   * so a ramp between two stable filters never passes through an unstable one.
+   */
+  inline void startRamp(const size_t _numStages, const int _numSamples) noexcept
+  {
+    jassert(_numStages <= MaxStages);
+    jassert(_numSamples > 0);
+    const size_t numStages = std::min(_numStages, MaxStages);
+    const float scale = 1.0f / static_cast<float>(std::max(_numSamples, 1));
+
+    computeSteps(coefficients.b0, rampTargets.b0, steps.b0, numStages, scale);
+    computeSteps(coefficients.b1, rampTargets.b1, steps.b1, numStages, scale);
+    computeSteps(coefficients.b2, rampTargets.b2, steps.b2, numStages, scale);
+    computeSteps(coefficients.a1, rampTargets.a1, steps.a1, numStages, scale);
+    computeSteps(coefficients.a2, rampTargets.a2, steps.a2, numStages, scale);
+  }
+
+  //============================================================================
+  /**
+   * @brief Copies the ramp targets into the coefficients without ramping.
+   *
+   * @param _numStages The number of stages to update, starting at the first.
+   */
+  inline void jumpToRampTargets(const size_t _numStages) noexcept
+  {
+    jassert(_numStages <= MaxStages);
+    const size_t numStages = std::min(_numStages, MaxStages);
+
+    const auto copyStages = [numStages](const auto& _source, auto& _target) {
+      std::copy(_source.begin(), _source.begin() + numStages, _target.begin());
+    };
+    copyStages(rampTargets.b0, coefficients.b0);
+    copyStages(rampTargets.b1, coefficients.b1);
+    copyStages(rampTargets.b2, coefficients.b2);
+    copyStages(rampTargets.a1, coefficients.a1);
+    copyStages(rampTargets.a2, coefficients.a2);
+  }
+
+  //============================================================================
+  /**
+   * @brief Clears the state of all stages.
+   */
+  inline void reset() noexcept
+  {
+    const auto zero = SIMD::expand(0.0f);
+    for (size_t stage = 0; stage < MaxStages; ++stage) {
+      z1States[stage].fill(zero);
+      z2States[stage].fill(zero);
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Processes one frame through the first stages of the cascade.
+   *
+   * @param _frame The samples of all channels, processed in place.
+   * @param _numStages The number of stages to run, starting at the first.
+   */
+  forcedinline void processFrame(Frame& _frame,
+                                 const size_t _numStages) noexcept
+  {
+    processFrameImpl<false>(_frame, _numStages);
+  }
+
+  //============================================================================
+  /**
+   * @brief Like processFrame(), but advances the coefficient ramp by a step.
+   *
+   * @param _frame The samples of all channels, processed in place.
+   * @param _numStages The number of stages to run, starting at the first.
+   */
+  forcedinline void processFrameRamped(Frame& _frame,
+                                       const size_t _numStages) noexcept
+  {
+    processFrameImpl<true>(_frame, _numStages);
+  }
+
+  //============================================================================
+  /**
+   * @brief Processes a block stage by stage instead of sample by sample.
+   *
+   * @param _channels One pointer per channel, processed in place.
+   * @param _numSamples The number of samples in each channel.
+   * @param _numStages The number of stages to run, starting at the first.
+   *
+   * @details
+   * The block is packed into SIMD frames in chunks of chunkSize samples. Each
+   * stage then runs over the whole chunk before the next stage starts, so its
+   * coefficients and state stay in registers instead of being reloaded for
+   * every sample. The coefficients must not change during the call.
+   *
+   * A single stage over a chunk is one long dependency chain, so stages are
+   * run in groups of stageGroupSize. Within a group, stage n works on frame f
+   * while stage n + 1 is still on frame f - 1, which gives the CPU independent
+   * work to overlap.
+   *
+   * The result is identical to calling processFrame() for every sample.
+   */
+  inline void processStageMajor(float* const* _channels,
+                                const int _numSamples,
+                                const size_t _numStages) noexcept
+  {
+    processStageMajorImpl<false>(_channels, _numSamples, _numStages);
+  }
+
+  //============================================================================
+  /**
+   * @brief Like processStageMajor(), but advances the coefficient ramp.
+   *
+   * @param _channels One pointer per channel, processed in place.
+   * @param _numSamples The number of samples in each channel.
+   * @param _numStages The number of stages to run, starting at the first.
+   *
+   * @details
+   * The result is identical to calling processFrameRamped() for every sample.
+   */
+  inline void processStageMajorRamped(float* const* _channels,
+                                      const int _numSamples,
+                                      const size_t _numStages) noexcept
+  {
+    processStageMajorImpl<true>(_channels, _numSamples, _numStages);
+  }
+
+private:
+  //============================================================================
+  /**
+   * @brief Shared implementation of processFrame() and processFrameRamped().
+   *
+   * @tparam Ramped Whether to advance the coefficient ramp.
+   * @param _frame The samples of all channels, processed in place.
+   * @param _numStages The number of stages to run, starting at the first.
+   */
+  template<bool Ramped>
+  forcedinline void processFrameImpl(Frame& _frame,
+                                     const size_t _numStages) noexcept
+  {
+    jassert(_numStages <= MaxStages);
+
+    alignas(sizeof(SIMD)) std::array<float, paddedChannels> lanes{};
+    std::copy(_frame.begin(), _frame.end(), lanes.begin());
+
+    Registers samples;
+    for (size_t reg = 0; reg < registerCount; ++reg)
+      samples[reg] = SIMD::fromRawArray(lanes.data() + reg * laneCount);
+
+    const size_t numStages = std::min(_numStages, MaxStages);
+    for (size_t stage = 0; stage < numStages; ++stage)
+      processStage<Ramped>(stage, samples);
+
+    for (size_t reg = 0; reg < registerCount; ++reg)
+      samples[reg].copyToRawArray(lanes.data() + reg * laneCount);
+    std::copy(lanes.begin(), lanes.begin() + NumChannels, _frame.begin());
+  }
+
+  //============================================================================
+  /**
+   * @brief Shared implementation of the stage-major process functions.
+   *
+   * @tparam Ramped Whether to advance the coefficient ramp.
+   * @param _channels One pointer per channel, processed in place.
+   * @param _numSamples The number of samples in each channel.
+   * @param _numStages The number of stages to run, starting at the first.
+   */
+  template<bool Ramped>
+  inline void processStageMajorImpl(float* const* _channels,
+                                    const int _numSamples,
+                                    const size_t _numStages) noexcept
+  {
+    jassert(_numStages <= MaxStages);
+    const size_t numStages = std::min(_numStages, MaxStages);
+
+    for (int offset = 0; offset < _numSamples; offset += chunkSize) {
+      const int numFrames = std::min(chunkSize, _numSamples - offset);
+
+      alignas(sizeof(SIMD)) std::array<float, paddedChannels> lanes{};
+      for (int frame = 0; frame < numFrames; ++frame) {
+        for (size_t channel = 0; channel < NumChannels; ++channel)
+          lanes[channel] = _channels[channel][offset + frame];
+        for (size_t reg = 0; reg < registerCount; ++reg)
+          chunk[frame][reg] =
+            SIMD::fromRawArray(lanes.data() + reg * laneCount);
+      }
+
+      size_t stage = 0;
+      for (; stage + stageGroupSize <= numStages; stage += stageGroupSize)
+        processStagesOverChunk<stageGroupSize, Ramped>(stage, numFrames);
+      for (; stage < numStages; ++stage)
+        processStagesOverChunk<1, Ramped>(stage, numFrames);
+
+      for (int frame = 0; frame < numFrames; ++frame) {
+        for (size_t reg = 0; reg < registerCount; ++reg)
+          chunk[frame][reg].copyToRawArray(lanes.data() + reg * laneCount);
+        for (size_t channel = 0; channel < NumChannels; ++channel)
+          _channels[channel][offset + frame] = lanes[channel];
+      }
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Runs one stage on all registers of a frame.
+   *
+   * @tparam Ramped Whether to advance the coefficient ramp.
+   * @param _stage The index of the stage.
+   * @param _samples The registers of the frame, processed in place.
+   */
+  template<bool Ramped>
+  forcedinline void processStage(const size_t _stage,
+                                 Registers& _samples) noexcept
+  {
+    const auto b0 = SIMD::expand(coefficients.b0[_stage]);
+    const auto b1 = SIMD::expand(coefficients.b1[_stage]);
+    const auto b2 = SIMD::expand(coefficients.b2[_stage]);
+    const auto a1 = SIMD::expand(coefficients.a1[_stage]);
+    const auto a2 = SIMD::expand(coefficients.a2[_stage]);
+
+    auto& z1 = z1States[_stage];
+    auto& z2 = z2States[_stage];
+
+    for (size_t reg = 0; reg < registerCount; ++reg) {
+      const SIMD input = _samples[reg];
+      const SIMD output = (b0 * input) + z1[reg];
+      z1[reg] = (b1 * input) - (a1 * output) + z2[reg];
+      z2[reg] = (b2 * input) - (a2 * output);
+      _samples[reg] = output;
+    }
+
+    if constexpr (Ramped) {
+      coefficients.b0[_stage] += steps.b0[_stage];
+      coefficients.b1[_stage] += steps.b1[_stage];
+      coefficients.b2[_stage] += steps.b2[_stage];
+      coefficients.a1[_stage] += steps.a1[_stage];
+      coefficients.a2[_stage] += steps.a2[_stage];
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Runs a group of consecutive stages over the scratch chunk.
+   *
+   * @tparam GroupSize The number of stages in the group.
+   * @tparam Ramped Whether to advance the coefficient ramp.
+   * @param _firstStage The index of the first stage in the group.
+   * @param _numFrames The number of valid frames in the chunk.
+   *
+   * @details
+   * When ramping, every register replays the same ramp from the stored
+   * coefficients, and only the last one writes the result back.
+   */
+  template<size_t GroupSize, bool Ramped>
+  forcedinline void processStagesOverChunk(const size_t _firstStage,
+                                           const int _numFrames) noexcept
+  {
+    for (size_t reg = 0; reg < registerCount; ++reg) {
+      SIMD b0[GroupSize], b1[GroupSize], b2[GroupSize];
+      SIMD a1[GroupSize], a2[GroupSize];
+      for (size_t i = 0; i < GroupSize; ++i) {
+        const size_t stage = _firstStage + i;
+        b0[i] = SIMD::expand(coefficients.b0[stage]);
+        b1[i] = SIMD::expand(coefficients.b1[stage]);
+        b2[i] = SIMD::expand(coefficients.b2[stage]);
+        a1[i] = SIMD::expand(coefficients.a1[stage]);
+        a2[i] = SIMD::expand(coefficients.a2[stage]);
+      }
+
+      SIMD db0[GroupSize], db1[GroupSize], db2[GroupSize];
+      SIMD da1[GroupSize], da2[GroupSize];
+      if constexpr (Ramped) {
+        for (size_t i = 0; i < GroupSize; ++i) {
+          const size_t stage = _firstStage + i;
+          db0[i] = SIMD::expand(steps.b0[stage]);
+          db1[i] = SIMD::expand(steps.b1[stage]);
+          db2[i] = SIMD::expand(steps.b2[stage]);
+          da1[i] = SIMD::expand(steps.a1[stage]);
+          da2[i] = SIMD::expand(steps.a2[stage]);
+        }
+      }
+
+      SIMD z1[GroupSize], z2[GroupSize];
+      for (size_t i = 0; i < GroupSize; ++i) {
+        z1[i] = z1States[_firstStage + i][reg];
+        z2[i] = z2States[_firstStage + i][reg];
+      }
+
+      for (int frame = 0; frame < _numFrames; ++frame) {
+        SIMD sample = chunk[frame][reg];
+        for (size_t i = 0; i < GroupSize; ++i) {
+          const SIMD input = sample;
+          sample = (b0[i] * input) + z1[i];
+          z1[i] = (b1[i] * input) - (a1[i] * sample) + z2[i];
+          z2[i] = (b2[i] * input) - (a2[i] * sample);
+
+          if constexpr (Ramped) {
+            b0[i] += db0[i];
+            b1[i] += db1[i];
+            b2[i] += db2[i];
+            a1[i] += da1[i];
+            a2[i] += da2[i];
+          }
+        }
+        chunk[frame][reg] = sample;
+      }
+
+      for (size_t i = 0; i < GroupSize; ++i) {
+        z1States[_firstStage + i][reg] = z1[i];
+        z2States[_firstStage + i][reg] = z2[i];
+      }
+
+      if constexpr (Ramped) {
+        if (reg == registerCount - 1) {
+          for (size_t i = 0; i < GroupSize; ++i) {
+            const size_t stage = _firstStage + i;
+            coefficients.b0[stage] = b0[i].get(0);
+            coefficients.b1[stage] = b1[i].get(0);
+            coefficients.b2[stage] = b2[i].get(0);
+            coefficients.a1[stage] = a1[i].get(0);
+            coefficients.a2[stage] = a2[i].get(0);
+          }
+        }
+      }
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Computes the per-sample ramp step of one coefficient array.
+   *
+   * @param _current The current coefficients.
+   * @param _target The ramp target coefficients.
+   * @param _step The array receiving the steps.
+   * @param _numStages The number of stages to compute.
+   * @param _scale One over the ramp length in samples.
+   */
+  static forcedinline void computeSteps(
+    const std::array<float, MaxStages>& _current,
+    const std::array<float, MaxStages>& _target,
+    std::array<float, MaxStages>& _step,
+    const size_t _numStages,
+    const float _scale) noexcept
+  {
+    for (size_t stage = 0; stage < _numStages; ++stage)
+      _step[stage] = (_target[stage] - _current[stage]) * _scale;
+  }
+
+  //============================================================================
+  Coefficients coefficients;
+  Coefficients rampTargets;
+  Coefficients steps;
+  States z1States;
+  States z2States;
+  std::array<Registers, chunkSize> chunk;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BiquadCascade)
+};
+
+//==============================================================================
+} // namespace filter
+} // namespace dsp
+} // namespace dmt
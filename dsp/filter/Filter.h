@@ -27,4 +27,10 @@
 
 #pragma once
 
-//==============================================================================
\ No newline at end of file
+//==============================================================================
+
+#include "./AllpassSweepConvolver.h"
+#include "./AllpassSweepGenerator.h"
+#include "./BiquadCascade.h"
+
+//==============================================================================
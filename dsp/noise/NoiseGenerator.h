@@ -0,0 +1,238 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Deterministic block noise generator. Every value is a hash of the seed, the
+ * channel and the position, so whole blocks can be generated in vectorized
+ * loops and renders can be reproduced from the seed alone.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <JuceHeader.h>
+#include <cstdint>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace noise {
+
+//==============================================================================
+/**
+ * @brief Counter-based generator for uniform white noise.
+ *
+ * @details
+ * The value at a position is a hash of that position and a key derived from
+ * the seed and the channel. Nothing depends on the previous value, so filling
+ * a block is a plain loop over 32 bit integer maths that the compiler
+ * vectorizes, and any block can be generated again without replaying the ones
+ * before it. The position wraps after 2^32 samples.
+ *
+ * Generating doesn't advance the generator. This way every channel of a block
+ * can be filled from the same position, and advance() is called once when the
+ * block is done. In the correlated stereo mode all channels share one stream,
+ * in the decorrelated mode every channel has its own.
+ *
+ * Nothing allocates or locks, so all functions are safe on the audio thread.
+ */
+class alignas(64) NoiseGenerator
+{
+public:
+  enum class StereoMode
+  {
+    Correlated,
+    Decorrelated,
+  };
+
+  //============================================================================
+  /**
+   * @brief Constructs a generator at the start of the sequence of a seed.
+   *
+   * @param _seed The seed. Equal seeds produce equal noise.
+   * @param _stereoMode Whether the channels share one stream.
+   */
+  explicit NoiseGenerator(
+    const std::uint64_t _seed = 0,
+    const StereoMode _stereoMode = StereoMode::Decorrelated) noexcept
+    : seed(_seed)
+    , stereoMode(_stereoMode)
+  {
+  }
+
+  //============================================================================
+  /**
+   * @brief Sets the seed and goes back to the start of its sequence.
+   *
+   * @param _seed The new seed.
+   */
+  inline void setSeed(const std::uint64_t _seed) noexcept
+  {
+    seed = _seed;
+    position = 0;
+  }
+
+  //============================================================================
+  /** @brief Goes back to the start of the sequence of the current seed. */
+  inline void reset() noexcept { position = 0; }
+
+  //============================================================================
+  /**
+   * @brief Sets whether the channels share one stream.
+   *
+   * @param _stereoMode The new stereo mode.
+   */
+  inline void setStereoMode(const StereoMode _stereoMode) noexcept
+  {
+    stereoMode = _stereoMode;
+  }
+
+  //============================================================================
+  [[nodiscard]] inline std::uint64_t getSeed() const noexcept { return seed; }
+
+  [[nodiscard]] inline StereoMode getStereoMode() const noexcept
+  {
+    return stereoMode;
+  }
+
+  //============================================================================
+  /**
+   * @brief Moves the generator forward.
+   *
+   * @param _numSamples The number of samples to skip.
+   */
+  inline void advance(const int _numSamples) noexcept
+  {
+    jassert(_numSamples >= 0);
+    position += static_cast<std::uint32_t>(_numSamples);
+  }
+
+  //============================================================================
+  /**
+   * @brief Fills a block with uniform noise of one channel.
+   *
+   * @param _destination The samples to write.
+   * @param _numSamples The number of samples.
+   * @param _channel The channel, which picks the stream.
+   * @param _min The lower bound of the noise.
+   * @param _max The upper bound of the noise, which is never reached.
+   *
+   * @details
+   * Starts at the current position and doesn't advance the generator.
+   */
+  inline void fill(float* _destination,
+                   const int _numSamples,
+                   const int _channel,
+                   const float _min = -1.0f,
+                   const float _max = 1.0f) const noexcept
+  {
+    const std::uint32_t key = getKey(_channel);
+    const float scale = (_max - _min) * unitScale;
+    for (int i = 0; i < _numSamples; ++i) {
+      const std::uint32_t counter = position + static_cast<std::uint32_t>(i);
+      _destination[i] = static_cast<float>(toMantissa(hash(counter, key))) *
+                          scale +
+                        _min;
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Fills every channel of a buffer with uniform noise and advances.
+   *
+   * @param _buffer The buffer to write.
+   * @param _min The lower bound of the noise.
+   * @param _max The upper bound of the noise, which is never reached.
+   */
+  inline void fill(juce::AudioBuffer<float>& _buffer,
+                   const float _min = -1.0f,
+                   const float _max = 1.0f) noexcept
+  {
+    const int numSamples = _buffer.getNumSamples();
+    for (int channel = 0; channel < _buffer.getNumChannels(); ++channel) {
+      fill(_buffer.getWritePointer(channel), numSamples, channel, _min, _max);
+    }
+    advance(numSamples);
+  }
+
+private:
+  //============================================================================
+  /** Maps the top 24 bits of a hash to [0, 1). */
+  static constexpr float unitScale = 1.0f / 16777216.0f;
+
+  //============================================================================
+  [[nodiscard]] inline std::uint32_t getKey(const int _channel) const noexcept
+  {
+    const auto stream = stereoMode == StereoMode::Correlated
+                          ? std::uint64_t{ 0 }
+                          : static_cast<std::uint64_t>(_channel);
+
+    // SplitMix64 finalizer, so that neighbouring seeds give unrelated keys
+    std::uint64_t z = seed + (stream + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return static_cast<std::uint32_t>(z ^ (z >> 31));
+  }
+
+  //============================================================================
+  /**
+   * Hashes a position with the lowbias32 integer hash by Chris Wellons. Only
+   * 32 bit multiplies, shifts and xors are used, which every SIMD instruction
+   * set has.
+   */
+  [[nodiscard]] static forcedinline std::uint32_t hash(
+    const std::uint32_t _counter,
+    const std::uint32_t _key) noexcept
+  {
+    std::uint32_t x = _counter * 0x9e3779b9u + _key;
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+  }
+
+  //============================================================================
+  /** Converting through a signed int is what SIMD instruction sets support. */
+  [[nodiscard]] static forcedinline std::int32_t toMantissa(
+    const std::uint32_t _hash) noexcept
+  {
+    return static_cast<std::int32_t>(_hash >> 8);
+  }
+
+  //============================================================================
+  std::uint64_t seed;
+  std::uint32_t position = 0;
+  StereoMode stereoMode;
+
+  //============================================================================
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NoiseGenerator)
+};
+
+//==============================================================================
+} // namespace noise
+} // namespace dsp
+} // namespace dmt
@@ -30,7 +30,9 @@
 //==============================================================================
 
 #include "AnalogWaveform.h"
+#include "utility/FastMath.h"
 #include <JuceHeader.h>
+#include <array>
 
 //==============================================================================
 
@@ -54,6 +56,9 @@ class alignas(64) AnalogOscillator
   static constexpr float twoPi = juce::MathConstants<float>::twoPi;
   static constexpr float pi = juce::MathConstants<float>::pi;
 
+  // Number of samples renderBlock() keeps phases for on the stack
+  static constexpr int renderChunkSize = 256;
+
 public:
   //==============================================================================
   /**
@@ -94,6 +99,91 @@ public:
     return std::clamp(sample, -1.0f, +1.0f);
   }
 
+  //==============================================================================
+  /**
+   * @brief Renders a block of samples.
+   * @param _output The buffer the samples are written to.
+   * @param _frequency The frequency in Hz for every sample.
+   * @param _numSamples The number of samples.
+   *
+   * @details
+   * Produces the same samples as calling setFrequency() and getNextSample()
+   * for every sample, up to the error of the approximations in FastMath.h.
+   * The waveform type and drive mode are picked once per block, and every
+   * stage of the phase pipeline runs as its own branch-free loop, so the
+   * compiler can vectorize all of them but the phase accumulation.
+   */
+  inline void renderBlock(float* _output,
+                          const float* _frequency,
+                          const int _numSamples) noexcept
+  {
+    TRACER("AnalogOscillator::renderBlock");
+
+    if (sampleRate <= 0.0f) {
+      std::fill(_output, _output + _numSamples, 0.0f);
+      return;
+    }
+
+    switch (waveform.type) {
+      case AnalogWaveform::Type::Sine:
+        renderBlock<AnalogWaveform::Type::Sine>(
+          _output, _frequency, _numSamples);
+        break;
+      case AnalogWaveform::Type::Saw:
+        renderBlock<AnalogWaveform::Type::Saw>(
+          _output, _frequency, _numSamples);
+        break;
+      case AnalogWaveform::Type::Triangle:
+        renderBlock<AnalogWaveform::Type::Triangle>(
+          _output, _frequency, _numSamples);
+        break;
+      case AnalogWaveform::Type::Square:
+        renderBlock<AnalogWaveform::Type::Square>(
+          _output, _frequency, _numSamples);
+        break;
+    }
+
+    if (_numSamples > 0) {
+      frequency = _frequency[_numSamples - 1];
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Shapes a block of phases into samples, without touching the phase.
+   * @param _output The buffer the samples are written to.
+   * @param _phases The raw phases, within [0, 2π).
+   * @param _numSamples The number of samples.
+   *
+   * @details
+   * Lets an owner that keeps its own phases, like UnisonOscillator, run many
+   * phases through the same shaping as renderBlock().
+   */
+  inline void renderPhases(float* _output,
+                           const float* _phases,
+                           const int _numSamples,
+                           const float /*_highestFrequency*/) const noexcept
+  {
+    TRACER("AnalogOscillator::renderPhases");
+
+    switch (waveform.type) {
+      case AnalogWaveform::Type::Sine:
+        shapeBlock<AnalogWaveform::Type::Sine>(_output, _phases, _numSamples);
+        break;
+      case AnalogWaveform::Type::Saw:
+        shapeBlock<AnalogWaveform::Type::Saw>(_output, _phases, _numSamples);
+        break;
+      case AnalogWaveform::Type::Triangle:
+        shapeBlock<AnalogWaveform::Type::Triangle>(
+          _output, _phases, _numSamples);
+        break;
+      case AnalogWaveform::Type::Square:
+        shapeBlock<AnalogWaveform::Type::Square>(
+          _output, _phases, _numSamples);
+        break;
+    }
+  }
+
   //==============================================================================
   /**
    * @brief Sets the frequency of the oscillator.
@@ -210,6 +300,109 @@ private:
   float syncModifier = 1.0f;
   float posityCycleRatio = 0.5f;
 
+  //==============================================================================
+  template<AnalogWaveform::Type WaveformType>
+  inline void renderBlock(float* _output,
+                          const float* _frequency,
+                          const int _numSamples) noexcept
+  {
+    std::array<float, renderChunkSize> phases;
+
+    for (int start = 0; start < _numSamples; start += renderChunkSize) {
+      const int chunkSize = std::min(renderChunkSize, _numSamples - start);
+      accumulatePhaseBlock(phases.data(), _frequency + start, chunkSize);
+      shapeBlock<WaveformType>(_output + start, phases.data(), chunkSize);
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Runs a block of raw phases through the whole shaping chain.
+   */
+  template<AnalogWaveform::Type WaveformType>
+  inline void shapeBlock(float* _output,
+                         const float* _phases,
+                         const int _numSamples) const noexcept
+  {
+    using dmt::math::branchlessSelect;
+
+    const float pwmEndPhase = twoPi / pwmModifier;
+    const float positiveCycleSize = posityCycleRatio * twoPi;
+    const float negativeCycleSize = (1.0f - posityCycleRatio) * twoPi;
+
+    // Synced and bended phase, see getSyncedPhase() and getBendedPhase()
+    for (int i = 0; i < _numSamples; ++i) {
+      const float syncedPhase = _phases[i] * pwmModifier * syncModifier;
+      const auto cycles =
+        static_cast<float>(static_cast<int>(syncedPhase * (1.0f / twoPi)));
+      float x = syncedPhase - cycles * twoPi;
+      x -= branchlessSelect(x >= twoPi, twoPi, 0.0f);
+      const float positive = x / (posityCycleRatio * 2.0f);
+      const float negative =
+        (x - positiveCycleSize) / negativeCycleSize * pi + pi;
+      _output[i] = branchlessSelect(x <= positiveCycleSize, positive, negative);
+    }
+
+    for (int i = 0; i < _numSamples; ++i) {
+      _output[i] = AnalogWaveform::getSampleKernel<WaveformType>(_output[i]);
+    }
+
+    distortBlock(_output, _numSamples);
+
+    // Past the pulse width the oscillator is silent
+    for (int i = 0; i < _numSamples; ++i) {
+      _output[i] = branchlessSelect(
+        _phases[i] >= pwmEndPhase,
+        0.0f,
+        dmt::math::branchlessClamp(_output[i], -1.0f, 1.0f));
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Writes the phase of every sample of a block, like advancePhase().
+   */
+  forcedinline void accumulatePhaseBlock(float* _phases,
+                                         const float* _frequency,
+                                         const int _numSamples) noexcept
+  {
+    const float phaseScale = twoPi / sampleRate;
+    for (int i = 0; i < _numSamples; ++i) {
+      _phases[i] = _frequency[i] * phaseScale;
+    }
+
+    // Every phase depends on the one before, so this loop stays scalar
+    float currentPhase = phase;
+    for (int i = 0; i < _numSamples; ++i) {
+      currentPhase += _phases[i];
+      currentPhase -=
+        dmt::math::branchlessSelect(currentPhase >= twoPi, twoPi, 0.0f);
+      _phases[i] = currentPhase;
+    }
+    phase = currentPhase;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Applies distortSample() to a block of samples.
+   */
+  forcedinline void distortBlock(float* _samples,
+                                 const int _numSamples) const noexcept
+  {
+    constexpr float magicNumber = 0.7615941559558f;
+    if (drive >= 1.0f) {
+      for (int i = 0; i < _numSamples; ++i) {
+        _samples[i] = Math::tanh(drive * _samples[i]) + bias;
+      }
+    } else {
+      const float dryGain = (1.0f - drive) * magicNumber;
+      for (int i = 0; i < _numSamples; ++i) {
+        const float wetSample = drive * Math::tanh(_samples[i]);
+        _samples[i] = wetSample + dryGain * _samples[i] + bias;
+      }
+    }
+  }
+
   //==============================================================================
   /**
    * @brief Advances the phase of the oscillator.
@@ -30,7 +30,13 @@
 //==============================================================================
 
 #include "dsp/synth/DigitalWaveform.h"
+#include "dsp/synth/Wavetable.h"
+#include "model/DigitalOscillatorParameters.h"
+#include "utility/FastMath.h"
 #include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <vector>
 
 //==============================================================================
 
@@ -46,6 +52,16 @@ namespace synth {
  * This class is designed for maximum real-time performance, using aggressive
  * optimizations such as constexpr, inline, noexcept, and forceinline. It
  * generates digital waveforms with various modulation capabilities.
+ *
+ * The whole shaping chain only depends on the phase, so it is rendered into
+ * a band-limited Wavetable whenever the parameters change. Playing the
+ * oscillator is a lookup into the mip level that fits the frequency.
+ * Oscillators with identical parameters share their table.
+ *
+ * Tables are built on the thread of the shared WavetableBuilder, and the
+ * oscillator plays the previous table until the new one is ready. The key of
+ * a table is quantized, so small parameter moves don't each build one. Only
+ * setSampleRate() builds right away, so it must not run on the audio thread.
  */
 class alignas(64) DigitalOscillator
 {
@@ -57,6 +73,12 @@ class alignas(64) DigitalOscillator
   static constexpr float halfPi = juce::MathConstants<float>::halfPi;
   static constexpr float pi = juce::MathConstants<float>::pi;
 
+  // Number of samples renderBlock() keeps phases for on the stack
+  static constexpr int renderChunkSize = 256;
+
+  // Number of steps the range of each shaping parameter has in a table key
+  static constexpr int wavetableKeySteps = 1024;
+
 public:
   struct Parameters
   {
@@ -109,28 +131,17 @@ public:
   DigitalOscillator() = default;
 
 public:
-  inline void setParameters(const juce::AudioProcessorValueTreeState& apvts,
-                            String prefix)
+  inline void setParameters(
+    const dmt::model::DigitalOscillatorParameterHandles& _handles) noexcept
   {
-    auto type = params.type;
-    float warp = params.warp;
-    float bend = params.getBend();
-    float pwm = params.pwm;
-    float sync = params.getSync();
-    float bias = params.bias;
-    float clip = params.clip;
-    float drive = params.drive;
-
-    String base = prefix + "DigitalOscillator";
-    type = static_cast<DigitalWaveform::Type>(
-      apvts.getRawParameterValue(base + "Type")->load());
-    bend = apvts.getRawParameterValue(base + "Bend")->load();
-    warp = apvts.getRawParameterValue(base + "Warp")->load();
-    pwm = apvts.getRawParameterValue(base + "Pwm")->load();
-    sync = apvts.getRawParameterValue(base + "Sync")->load();
-    bias = apvts.getRawParameterValue(base + "Bias")->load();
-    clip = apvts.getRawParameterValue(base + "Clip")->load();
-    drive = apvts.getRawParameterValue(base + "Drive")->load();
+    const auto type = _handles.type.load();
+    const float bend = _handles.bend.load();
+    const float warp = _handles.warp.load();
+    const float pwm = _handles.pwm.load();
+    const float sync = _handles.sync.load();
+    const float bias = _handles.bias.load();
+    const float clip = _handles.clip.load();
+    const float drive = _handles.drive.load();
 
     // These don't need mapping so we can set them directly
     waveform.type = type;
@@ -143,21 +154,31 @@ public:
     // These need mapping so we use setters to do that
     params.setBend(bend);
     params.setSync(sync);
+    rawBend = bend;
+    rawSync = sync;
 
     // Eagerly compute PWM end sample
     computePwmEndSample();
+    updateWavetable();
   }
 
   //==============================================================================
   /**
    * @brief Sets the sample rate for the oscillator.
    * @param _newSampleRate The new sample rate in Hz.
+   *
+   * @details
+   * Builds the table for the current parameters right away, which allocates.
    */
   inline void setSampleRate(const float _newSampleRate) noexcept
   {
     TRACER("DigitalOscillator::setSampleRate");
     sampleRate = _newSampleRate;
     computePwmEndSample();
+
+    if (wavetableRequest == nullptr)
+      wavetableRequest = std::make_unique<WavetableRequest>(&buildWavetable);
+    wavetableRequest->buildNow(getWavetableKey(), wavetable);
   }
 
   //==============================================================================
@@ -169,32 +190,83 @@ public:
   {
     TRACER("DigitalOscillator::getNextSample");
 
-    using std::pow, std::clamp;
-
-    if (sampleRate <= 0.0f)
+    if (sampleRate <= 0.0f || wavetable == nullptr)
       return 0.0f;
 
     advancePhase();
 
-    auto warpedPhase = getWarpPhase(phase);
-    auto syncedPhase = getSyncedPhase(warpedPhase);
-    auto bendedPhase = getBendedPhase(syncedPhase);
+    const int level = Wavetable::getLevel(frequency, sampleRate);
+    return wavetable->getSample(level, phase);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Renders a block of samples.
+   * @param _output The buffer the samples are written to.
+   * @param _frequency The frequency in Hz for every sample.
+   * @param _numSamples The number of samples.
+   *
+   * @details
+   * Produces the same samples as calling setFrequency() and getNextSample()
+   * for every sample, except that the mip level is picked once per chunk
+   * from its highest frequency.
+   */
+  inline void renderBlock(float* _output,
+                          const float* _frequency,
+                          const int _numSamples) noexcept
+  {
+    TRACER("DigitalOscillator::renderBlock");
+
+    if (sampleRate <= 0.0f || wavetable == nullptr) {
+      std::fill(_output, _output + _numSamples, 0.0f);
+      return;
+    }
+
+    std::array<float, renderChunkSize> phases;
 
-    auto pwmPhase = bendedPhase;
-    auto pwm = params.pwm;
-    const float pwmNormalized = 1.0f - (pwm / 100.0f); // 0.8
+    for (int start = 0; start < _numSamples; start += renderChunkSize) {
+      const int chunkSize = std::min(renderChunkSize, _numSamples - start);
+      const float* frequency = _frequency + start;
+      accumulatePhaseBlock(phases.data(), frequency, chunkSize);
+
+      const float highestFrequency =
+        *std::max_element(frequency, frequency + chunkSize);
+      const int level = Wavetable::getLevel(highestFrequency, sampleRate);
+      wavetable->renderBlock(_output + start, phases.data(), chunkSize, level);
+    }
 
-    if (pwmPhase >= twoPi * pwmNormalized) {
-      return pwmEndSample;
+    if (_numSamples > 0) {
+      frequency = _frequency[_numSamples - 1];
     }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Reads the wavetable for a block of phases, without touching the
+   * phase of the oscillator.
+   * @param _output The buffer the samples are written to.
+   * @param _phases The raw phases, within [0, 2π).
+   * @param _numSamples The number of samples.
+   * @param _highestFrequency The highest frequency any of the phases runs at.
+   *
+   * @details
+   * Lets an owner that keeps its own phases, like UnisonOscillator, play many
+   * phases from the same table.
+   */
+  inline void renderPhases(float* _output,
+                           const float* _phases,
+                           const int _numSamples,
+                           const float _highestFrequency) const noexcept
+  {
+    TRACER("DigitalOscillator::renderPhases");
 
-    if (pwmNormalized > 0.0f || pwmNormalized < 1.0f) {
-      pwmPhase = clamp(pwmPhase / pwmNormalized, 0.0f, twoPi);
+    if (sampleRate <= 0.0f || wavetable == nullptr) {
+      std::fill(_output, _output + _numSamples, 0.0f);
+      return;
     }
 
-    float sample = waveform.getSample(pwmPhase);
-    sample = distortSample(sample);
-    return clamp(sample, -1.0f, +1.0f);
+    const int level = Wavetable::getLevel(_highestFrequency, sampleRate);
+    wavetable->renderBlock(_output, _phases, _numSamples, level);
   }
 
   //==============================================================================
@@ -330,6 +402,316 @@ public:
   }
 
 private:
+  //==============================================================================
+  /**
+   * @brief A range of a shaping parameter, split into wavetableKeySteps.
+   */
+  struct KeyRange
+  {
+    float start;
+    float end;
+
+    [[nodiscard]] inline int quantize(const float _value) const noexcept
+    {
+      const float normalised = (_value - start) / (end - start);
+      return juce::roundToInt(juce::jlimit(0.0f, 1.0f, normalised) *
+                              static_cast<float>(wavetableKeySteps));
+    }
+
+    [[nodiscard]] inline float dequantize(const int _step) const noexcept
+    {
+      return start + (end - start) * static_cast<float>(_step) /
+                       static_cast<float>(wavetableKeySteps);
+    }
+  };
+
+  // Bend and sync are kept in their parameter ranges, before mapping
+  static constexpr KeyRange biasRange{ -1.0f, 1.0f };
+  static constexpr KeyRange driveRange{ -20.0f, 20.0f };
+  static constexpr KeyRange pwmRange{ 0.0f, 100.0f };
+  static constexpr KeyRange clipRange{ 0.0f, 1.0f };
+  static constexpr KeyRange warpRange{ 0.0f, 1.0f };
+  static constexpr KeyRange syncRange{ 0.0f, 100.0f };
+  static constexpr KeyRange bendRange{ -100.0f, 100.0f };
+
+  //==============================================================================
+  /**
+   * @brief Everything the shaped cycle depends on, quantized.
+   */
+  struct WavetableKey
+  {
+    DigitalWaveform::Type type = DigitalWaveform::Type::Sine;
+    int bias = 0;
+    int drive = 0;
+    int pwm = 0;
+    int clip = 0;
+    int warp = 0;
+    int sync = 0;
+    int bend = 0;
+
+    bool operator==(const WavetableKey& _other) const noexcept = default;
+  };
+
+  using WavetableRequest = WavetableBuilder<WavetableKey>::Request;
+
+  //==============================================================================
+  /**
+   * @brief Quantizes the current parameters into a table key.
+   */
+  [[nodiscard]] WavetableKey getWavetableKey() const noexcept
+  {
+    return { waveform.type,
+             biasRange.quantize(params.bias),
+             driveRange.quantize(params.drive),
+             pwmRange.quantize(params.pwm),
+             clipRange.quantize(params.clip),
+             warpRange.quantize(params.warp),
+             syncRange.quantize(rawSync),
+             bendRange.quantize(rawBend) };
+  }
+
+  //==============================================================================
+  /**
+   * @brief Asks for the table of the current parameters and swaps in any
+   * table that finished building.
+   *
+   * @details
+   * Safe on the audio thread, it neither allocates, frees nor waits.
+   */
+  void updateWavetable() noexcept
+  {
+    TRACER("DigitalOscillator::updateWavetable");
+
+    // Nothing is built before setSampleRate() created the request
+    if (wavetableRequest == nullptr)
+      return;
+
+    wavetableRequest->request(getWavetableKey());
+    wavetableRequest->takeFinished(wavetable);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Builds the table of a key. Runs on the builder thread.
+   *
+   * @details
+   * The cycle is shaped from the quantized parameters, so every oscillator
+   * that shares the table gets exactly the same one.
+   */
+  [[nodiscard]] static std::shared_ptr<const Wavetable> buildWavetable(
+    const WavetableKey& _key)
+  {
+    TRACER("DigitalOscillator::buildWavetable");
+
+    DigitalOscillator shaper;
+    shaper.waveform.type = _key.type;
+    shaper.params.bias = biasRange.dequantize(_key.bias);
+    shaper.params.drive = driveRange.dequantize(_key.drive);
+    shaper.params.pwm = pwmRange.dequantize(_key.pwm);
+    shaper.params.clip = clipRange.dequantize(_key.clip);
+    shaper.params.warp = warpRange.dequantize(_key.warp);
+    shaper.params.setSync(syncRange.dequantize(_key.sync));
+    shaper.params.setBend(bendRange.dequantize(_key.bend));
+    shaper.computePwmEndSample();
+    return shaper.renderWavetable();
+  }
+
+  //==============================================================================
+  /**
+   * @brief Renders one shaped cycle and builds its mip levels.
+   */
+  [[nodiscard]] std::shared_ptr<const Wavetable> renderWavetable() const
+  {
+    TRACER("DigitalOscillator::renderWavetable");
+
+    std::vector<float> phases(Wavetable::size);
+    std::vector<float> cycle(Wavetable::size);
+    for (int i = 0; i < Wavetable::size; ++i) {
+      phases[i] = twoPi * static_cast<float>(i) / Wavetable::size;
+    }
+
+    switch (waveform.type) {
+      case DigitalWaveform::Type::Sine:
+        shapeBlock<DigitalWaveform::Type::Sine>(
+          cycle.data(), phases.data(), Wavetable::size);
+        break;
+      case DigitalWaveform::Type::Saw:
+        shapeBlock<DigitalWaveform::Type::Saw>(
+          cycle.data(), phases.data(), Wavetable::size);
+        break;
+      case DigitalWaveform::Type::Triangle:
+        shapeBlock<DigitalWaveform::Type::Triangle>(
+          cycle.data(), phases.data(), Wavetable::size);
+        break;
+      case DigitalWaveform::Type::Square:
+        shapeBlock<DigitalWaveform::Type::Square>(
+          cycle.data(), phases.data(), Wavetable::size);
+        break;
+    }
+
+    return std::make_shared<const Wavetable>(cycle.data());
+  }
+
+  //==============================================================================
+  /**
+   * @brief Runs a block of raw phases through the whole shaping chain.
+   * @param _output The buffer the shaped samples are written to.
+   * @param _phases The raw phases, overwritten with the bended phases.
+   * @param _numSamples The number of samples.
+   */
+  template<DigitalWaveform::Type WaveformType>
+  inline void shapeBlock(float* _output,
+                         float* _phases,
+                         const int _numSamples) const noexcept
+  {
+    warpPhaseBlock(_phases, _numSamples);
+    syncPhaseBlock(_phases, _numSamples);
+    bendPhaseBlock(_phases, _numSamples);
+
+    const float pwmNormalized = 1.0f - (params.pwm / 100.0f);
+    for (int i = 0; i < _numSamples; ++i) {
+      const float pwmPhase =
+        dmt::math::branchlessClamp(_phases[i] / pwmNormalized, 0.0f, twoPi);
+      _output[i] = DigitalWaveform::getSampleKernel<WaveformType>(pwmPhase);
+    }
+
+    distortBlock(_output, _numSamples);
+
+    // Past the pulse width the end of the cycle is held
+    const float pwmEndPhase = twoPi * pwmNormalized;
+    for (int i = 0; i < _numSamples; ++i) {
+      _output[i] = dmt::math::branchlessSelect(
+        _phases[i] >= pwmEndPhase,
+        pwmEndSample,
+        dmt::math::branchlessClamp(_output[i], -1.0f, 1.0f));
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Writes the phase of every sample of a block, like advancePhase().
+   */
+  forcedinline void accumulatePhaseBlock(float* _phases,
+                                         const float* _frequency,
+                                         const int _numSamples) noexcept
+  {
+    const float phaseScale = twoPi / sampleRate;
+    for (int i = 0; i < _numSamples; ++i) {
+      _phases[i] = _frequency[i] * phaseScale;
+    }
+
+    // Every phase depends on the one before, so this loop stays scalar
+    float currentPhase = phase;
+    for (int i = 0; i < _numSamples; ++i) {
+      currentPhase += _phases[i];
+      currentPhase -=
+        dmt::math::branchlessSelect(currentPhase >= twoPi, twoPi, 0.0f);
+      _phases[i] = currentPhase;
+    }
+    phase = currentPhase;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Applies getWarpPhase() to a block of phases.
+   */
+  forcedinline void warpPhaseBlock(float* _phases,
+                                   const int _numSamples) const noexcept
+  {
+    const float k = params.warp;
+    for (int i = 0; i < _numSamples; ++i) {
+      const float x = _phases[i] / pi;
+      const float rising = (1.0f + 2.0f * k) * x;
+      const float falling = (1.0f - 2.0f * k) * x + 2.0f * k;
+      const float wrapped = (1.0f + 2.0f * k) * x - 4.0f * k;
+      _phases[i] =
+        dmt::math::branchlessSelect(
+          x < 0.5f,
+          rising,
+          dmt::math::branchlessSelect(x < 1.5f, falling, wrapped)) *
+        pi;
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Applies getSyncedPhase() to a block of phases.
+   */
+  forcedinline void syncPhaseBlock(float* _phases,
+                                   const int _numSamples) const noexcept
+  {
+    const float sync = params.getSync();
+    for (int i = 0; i < _numSamples; ++i) {
+      // Phases aren't negative, so truncating counts the whole cycles
+      const float syncedPhase = _phases[i] * sync;
+      const auto cycles = static_cast<float>(
+        static_cast<int>(syncedPhase * (1.0f / twoPi)));
+      const float wrappedPhase = syncedPhase - cycles * twoPi;
+      _phases[i] = wrappedPhase - dmt::math::branchlessSelect(
+                                    wrappedPhase >= twoPi, twoPi, 0.0f);
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Applies getBendedPhase() to a block of phases.
+   */
+  forcedinline void bendPhaseBlock(float* _phases,
+                                   const int _numSamples) const noexcept
+  {
+    const float bend = params.getBend();
+    const float positiveCycleSize = bend * twoPi;
+    const float negativeCycleSize = (1.0f - bend) * twoPi;
+    for (int i = 0; i < _numSamples; ++i) {
+      const float x = _phases[i];
+      const float positive = x / (bend * 2.0f);
+      const float negative =
+        (x - positiveCycleSize) / negativeCycleSize * pi + pi;
+      _phases[i] =
+        dmt::math::branchlessSelect(x <= positiveCycleSize, positive, negative);
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Applies distortSample() to a block of samples.
+   */
+  forcedinline void distortBlock(float* _samples,
+                                 const int _numSamples) const noexcept
+  {
+    using dmt::math::branchlessClamp;
+
+    const float drive = params.drive;
+    const float bias = params.bias;
+    const float clip = params.clip + 1.0f;
+    const float k = std::abs(drive);
+
+    if (k < 0.01f) {
+      for (int i = 0; i < _numSamples; ++i) {
+        _samples[i] = branchlessClamp((_samples[i] + bias) * clip, -1.0f, 1.0f);
+      }
+    } else if (drive > 0.0f) {
+      const float inverseNormalizer = 1.0f / std::atan(k);
+      for (int i = 0; i < _numSamples; ++i) {
+        const float clipSample =
+          branchlessClamp((_samples[i] + bias) * clip, -1.0f, 1.0f);
+        _samples[i] = dmt::math::fastAtan(k * clipSample) * inverseNormalizer;
+      }
+    } else {
+      // The tangent stays below atan(4) < pi / 2, where fastTan() is accurate
+      const float normalizer = std::atan(k * 0.2f);
+      const float inverseScale = 1.0f / (k * 0.2f);
+      for (int i = 0; i < _numSamples; ++i) {
+        const float clipSample =
+          branchlessClamp((_samples[i] + bias) * clip, -1.0f, 1.0f);
+        const float angle = clipSample * normalizer;
+        _samples[i] =
+          dmt::math::withSignOf(dmt::math::fastTan(std::abs(angle)), angle) *
+          inverseScale;
+      }
+    }
+  }
+
   //==============================================================================
   /**
    * @brief Computes the PWM end-of-cycle sample.
@@ -353,6 +735,10 @@ private:
   float sampleRate = -1.0f;
   float phase = 0.0f;
   float pwmEndSample = 0.0f;
+  float rawSync = 0.0f;
+  float rawBend = 0.0f;
+  std::shared_ptr<const Wavetable> wavetable;
+  std::unique_ptr<WavetableRequest> wavetableRequest;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DigitalOscillator)
   //==============================================================================
@@ -29,6 +29,7 @@
 
 //==============================================================================
 
+#include "utility/FastMath.h"
 #include <JuceHeader.h>
 
 //==============================================================================
@@ -147,6 +148,41 @@ struct DigitalWaveform
     }
   }
 
+  //==============================================================================
+  /**
+   * @brief Generate a waveform sample of a fixed type without branching.
+   * @tparam WaveformType The waveform type.
+   * @param _x The phase of the waveform, within [0, 2π].
+   * @return The waveform sample.
+   *
+   * @details
+   * Matches getSample() up to the error of the approximations in FastMath.h,
+   * and can be called from loops the compiler vectorizes.
+   */
+  template<Type WaveformType>
+  [[nodiscard]] static forcedinline float getSampleKernel(
+    const float _x) noexcept
+  {
+    using dmt::math::branchlessSelect;
+
+    if constexpr (WaveformType == Type::Sine) {
+      return dmt::math::fastSin(_x);
+    } else if constexpr (WaveformType == Type::Saw) {
+      return 2.0f * (_x / twoPi - 0.5f);
+    } else if constexpr (WaveformType == Type::Triangle) {
+      const float saw = 2.0f * (_x / twoPi - 0.5f);
+      const float folded = branchlessSelect(
+        saw > 0.5f,
+        1.0f - saw,
+        branchlessSelect(saw < -0.5f, -1.0f - saw, saw));
+      return 2.0f * folded;
+    } else {
+      static_assert(WaveformType == Type::Square);
+      // The sine is positive exactly between 0 and pi
+      return branchlessSelect((_x > 0.0f) & (_x < pi), 1.0f, -1.0f);
+    }
+  }
+
   //==============================================================================
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DigitalWaveform)
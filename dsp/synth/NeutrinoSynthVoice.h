@@ -29,9 +29,13 @@
 
 //==============================================================================
 
+#include "dsp/data/EventQueue.h"
 #include "dsp/envelope/AdhEnvelope.h"
+#include "dsp/envelope/ControlRateModulator.h"
 #include "dsp/synth/DigitalOscillator.h"
+#include "model/NeutrinoParameters.h"
 #include <JuceHeader.h>
+#include <array>
 
 //==============================================================================
 
@@ -46,8 +50,21 @@ class alignas(64) NeutrinoSynthVoice : public juce::SynthesiserVoice
   using DigitalOscillator = dmt::dsp::synth::DigitalOscillator;
   using DigitalWaveform = dmt::dsp::synth::DigitalWaveform;
   using AhdEnvelope = dmt::dsp::envelope::AhdEnvelope;
+  using ControlRateModulator = dmt::dsp::envelope::ControlRateModulator;
+
+  // Number of samples the oscillator renders at once
+  static constexpr int renderChunkSize = 256;
+
+  // Pitch of the oscillator relative to the note, and its limits
+  static constexpr int octave = -1;
+  static constexpr int semitone = 0;
+  static constexpr float minFrequency = 20.0f;
+  static constexpr float maxFrequency = 20000.0f;
 
 public:
+  using EventQueue = dmt::dsp::data::EventQueue<>;
+  using Event = dmt::dsp::data::ProcessorEvent;
+
   //==============================================================================
   /**
    * @brief Constructor for SynthVoice.
@@ -118,14 +135,38 @@ public:
     if (_sampleRate <= 0)
       return;
 
+    parameters.resolve(dmt::model::ParameterRegistry(apvts));
+
     gainEnvelope.setSampleRate(static_cast<float>(_sampleRate));
     pitchEnv1.setSampleRate(static_cast<float>(_sampleRate));
     pitchEnv2.setSampleRate(static_cast<float>(_sampleRate));
     osc.setSampleRate(static_cast<float>(_sampleRate));
 
+    sampleClock = 0;
     isPrepared = true;
   }
 
+  //==============================================================================
+  /**
+   * @brief Sets whether the pitch envelopes run at audio or control rate.
+   * @param _quality AudioRate evaluates getNextFrequency() for every sample.
+   */
+  void setModulationQuality(
+    const ControlRateModulator::Quality _quality) noexcept
+  {
+    pitchModulator.setQuality(_quality);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets the number of samples between two pitch evaluations.
+   * @param _interval The interval used at control rate.
+   */
+  void setControlInterval(const int _interval) noexcept
+  {
+    pitchModulator.setInterval(_interval);
+  }
+
   //==============================================================================
   /**
    * @brief Starts a note.
@@ -135,7 +176,7 @@ public:
    * @param _currentPitchWheelPosition The current pitch wheel position.
    */
   void startNote(int _midiNoteNumber,
-                 float /*_velocity*/,
+                 float _velocity,
                  juce::SynthesiserSound* /*_sound*/,
                  int /*_currentPitchWheelPosition*/) noexcept override
   {
@@ -143,20 +184,31 @@ public:
 
     note = _midiNoteNumber;
 
-    updateEnvelopeParameters();
+    if (isPrepared)
+      updateEnvelopeParameters();
     gainEnvelope.noteOn();
     pitchEnv1.noteOn();
     pitchEnv2.noteOn();
     osc.reset();
 
-    callOnNoteReceivers();
+    pushNoteOn(_velocity);
   }
 
   //==============================================================================
-  void stopNote(float /*_velocity*/, bool /*_allowTailOff*/) noexcept override
+  /**
+   * @brief Stops the note.
+   * @param _velocity The release velocity.
+   * @param _allowTailOff Whether the note may ring out.
+   *
+   * @details
+   * The gain envelope has no release, so a tail-off lets it play to the end
+   * and renderNextBlock() frees the voice once it is idle.
+   */
+  void stopNote(float /*_velocity*/, bool _allowTailOff) noexcept override
   {
     TRACER("NeutrinoSynthVoice::stopNote");
-    // clearCurrentNote();
+    if (!_allowTailOff)
+      clearCurrentNote();
   }
 
   /**
@@ -170,6 +222,9 @@ public:
                        int _numSamples) noexcept override
   {
     TRACER("NeutrinoSynthVoice::renderNextBlock");
+    // Counted for every voice, so a note-on knows where it starts
+    sampleClock += _numSamples;
+
     if (!isVoiceActive() || !isPrepared)
       return;
 
@@ -178,19 +233,38 @@ public:
 
     const float oscGain = 0.0f;
 
-    const auto endSample = _numSamples + _startSample;
-    auto* leftChannel = _outputBuffer.getWritePointer(0);
-    auto* rightChannel = _outputBuffer.getWritePointer(1);
+    auto* leftChannel = _outputBuffer.getWritePointer(0, _startSample);
+    auto* rightChannel = _outputBuffer.getWritePointer(1, _startSample);
 
-    for (int sample = _startSample; sample < endSample; ++sample) {
-      const float freq = getNextFrequency();
-      osc.setFrequency(freq);
+    std::array<float, renderChunkSize> frequencies;
+    std::array<float, renderChunkSize> rawSamples;
+    std::array<float, renderChunkSize> gains;
 
-      float rawSample = osc.getNextSample();
+    for (int start = 0; start < _numSamples; start += renderChunkSize) {
+      const int chunkSize = std::min(renderChunkSize, _numSamples - start);
 
-      const auto gainedSample = applyGain(rawSample, oscGain);
-      leftChannel[sample] += gainedSample;
-      rightChannel[sample] += gainedSample;
+      if (pitchModulator.isAudioRate()) {
+        for (int i = 0; i < chunkSize; ++i) {
+          frequencies[i] = getNextFrequency();
+        }
+      } else {
+        renderFrequencies(frequencies.data(), chunkSize);
+      }
+
+      osc.renderBlock(rawSamples.data(), frequencies.data(), chunkSize);
+
+      renderGains(gains.data(), chunkSize, oscGain);
+
+      for (int i = 0; i < chunkSize; ++i) {
+        const auto gainedSample = rawSamples[i] * gains[i];
+        leftChannel[start + i] += gainedSample;
+        rightChannel[start + i] += gainedSample;
+      }
+
+      if (gainEnvelope.isIdle()) {
+        clearCurrentNote();
+        return;
+      }
     }
   }
 
@@ -208,10 +282,8 @@ public:
     using juce::mapToLog10, juce::MidiMessage;
     using std::clamp;
 
-    const int octave = -1;
-    const int semitone = 0;
-    const float minFreq = 20.0f;
-    const float maxFreq = 20000.0f;
+    const float minFreq = minFrequency;
+    const float maxFreq = maxFrequency;
     const int baseNote = (note + semitone + (octave * 12));
     const float baseFreq = MidiMessage::getMidiNoteInHertz(baseNote);
 
@@ -236,76 +308,122 @@ public:
 
   //==============================================================================
   /**
-   * @brief Adds a callback function to be called when a note is received.
-   * @param _callbackFunction The callback function.
+   * @brief Sets the queue the voice reports its note-ons to.
+   * @param _eventQueue The queue of the processor, or nullptr for none.
+   *
+   * @details
+   * All voices of a synthesiser run on the audio thread, so they can share
+   * the single producer side of one queue.
    */
-  void addOnNoteReceivers(std::function<void()> _callbackFunction) noexcept
+  void setEventQueue(EventQueue* _eventQueue) noexcept
   {
-    TRACER("SynthVoice::addOnNoteReceivers");
-    onNoteReceivers.push_back(std::move(_callbackFunction));
+    TRACER("SynthVoice::setEventQueue");
+    eventQueue = _eventQueue;
   }
 
   //==============================================================================
   /**
-   * @brief Calls all registered note receiver callback functions.
+   * @brief Reports a note-on to the event queue.
+   * @param _velocity The velocity of the note.
    */
-  void callOnNoteReceivers() noexcept
+  void pushNoteOn(float _velocity) noexcept
   {
-    TRACER("SynthVoice::callOnNoteReceivers");
-    for (const auto& func : onNoteReceivers) {
-      func();
-    }
+    TRACER("SynthVoice::pushNoteOn");
+    if (eventQueue != nullptr)
+      eventQueue->push({ Event::Type::NoteOn, sampleClock, note, _velocity });
   }
 
 protected:
   //==============================================================================
   /**
-   * @brief Updates the envelope parameters from the
-   * AudioProcessorValueTreeState.
+   * @brief Renders the frequencies of a block at control rate.
+   * @param _frequencies The buffer the frequencies are written to.
+   * @param _numSamples The number of samples.
+   *
+   * @details
+   * Evaluates the same pitch as getNextFrequency(), but only once per
+   * control interval, and moves the pitch envelopes past the block.
+   */
+  void renderFrequencies(float* _frequencies, const int _numSamples) noexcept
+  {
+    TRACER("SynthVoice::renderFrequencies");
+    using juce::mapToLog10;
+
+    const int baseNote = (note + semitone + (octave * 12));
+    const auto baseFreq =
+      static_cast<float>(juce::MidiMessage::getMidiNoteInHertz(baseNote));
+    const auto kernel1 = pitchEnv1.getKernel();
+    const auto kernel2 = pitchEnv2.getKernel();
+    const float oscModDepth1 = pitchEnv1.getParameters().depth;
+    const float oscModDepth2 = pitchEnv2.getParameters().depth;
+
+    const auto startIndex = static_cast<float>(pitchEnv1.getSampleIndex());
+    pitchModulator.render(
+      _frequencies, _numSamples, startIndex, [&](const float _index) {
+        const float osc1ModSample = mapToLog10(
+          kernel1.getValue(_index) * oscModDepth1, minFrequency, maxFrequency);
+        const float osc2ModSample = mapToLog10(
+          kernel2.getValue(_index) * oscModDepth2, minFrequency, maxFrequency);
+        const float modulatedFreq = baseFreq + osc1ModSample + osc2ModSample;
+        return std::clamp(modulatedFreq, minFrequency, maxFrequency);
+      });
+
+    pitchEnv1.skip(static_cast<size_t>(_numSamples));
+    pitchEnv2.skip(static_cast<size_t>(_numSamples));
+  }
+
+  //==============================================================================
+  /**
+   * @brief Updates the envelope parameters through the resolved handles.
    */
   void updateEnvelopeParameters() noexcept
   {
     TRACER("SynthVoice::updateEnvelopeParameters");
-    gainEnvelope.setParameters(apvts, "NeutrinoGain");
-    pitchEnv1.setParameters(apvts, "NeutrinoPitch1");
-    pitchEnv2.setParameters(apvts, "NeutrinoPitch2");
+    gainEnvelope.setParameters(parameters.gainEnvelope);
+    pitchEnv1.setParameters(parameters.pitchEnvelope1);
+    pitchEnv2.setParameters(parameters.pitchEnvelope2);
   }
 
   //==============================================================================
   /**
-   * @brief Updates the oscillator parameters from the
-   * AudioProcessorValueTreeState.
+   * @brief Updates the oscillator parameters through the resolved handles.
    */
   void updateOscillatorParameters() noexcept
   {
     TRACER("SynthVoice::updateOscillatorParameters");
-    osc.setParameters(apvts, "Neutrino");
+    osc.setParameters(parameters.oscillator);
   }
 
   //==============================================================================
   /**
-   * @brief Applies gain to a sample.
-   * @param _sample The input sample.
+   * @brief Renders the gain of the next block.
+   * @param _gains The buffer the gains are written to.
+   * @param _numSamples The number of samples.
    * @param _oscGain The oscillator gain.
-   * @return The gained sample.
    */
-  [[nodiscard]] float applyGain(float _sample, float _oscGain) noexcept
+  void renderGains(float* _gains, int _numSamples, float _oscGain) noexcept
   {
-    TRACER("SynthVoice::applyGain");
-    const float envGain = gainEnvelope.getNextSample();
+    TRACER("SynthVoice::renderGains");
+    gainEnvelope.renderBlock(_gains, _numSamples);
     const float gain = juce::Decibels::decibelsToGain(_oscGain, -96.0f);
-    return _sample * envGain * gain;
+    for (int i = 0; i < _numSamples; ++i) {
+      _gains[i] *= gain;
+    }
   }
 
 private:
   juce::AudioProcessorValueTreeState& apvts;
+  dmt::model::NeutrinoParameterHandles parameters;
   DigitalOscillator osc;
   AhdEnvelope gainEnvelope;
   AhdEnvelope pitchEnv1;
   AhdEnvelope pitchEnv2;
+  ControlRateModulator pitchModulator;
   int note = 0;
   bool isPrepared = false;
-  std::vector<std::function<void()>> onNoteReceivers;
+  EventQueue* eventQueue = nullptr;
+  // Samples the synthesiser has rendered, whether this voice played or not
+  std::int64_t sampleClock = 0;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NeutrinoSynthVoice)
 };
@@ -33,5 +33,9 @@
 #include "./DigitalWaveform.h"
 #include "./NeutrinoSynthVoice.h"
 #include "./SynthSound.h"
+#include "./SynthVoice.h"
+#include "./UnisonOscillator.h"
+#include "./VoiceManager.h"
+#include "./Wavetable.h"
 
 //==============================================================================
\ No newline at end of file
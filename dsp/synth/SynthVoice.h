@@ -29,9 +29,14 @@
 
 //==============================================================================
 
+#include "dsp/data/EventQueue.h"
 #include "dsp/envelope/AdhEnvelope.h"
+#include "dsp/envelope/ControlRateModulator.h"
 #include "dsp/synth/AnalogOscillator.h"
+#include "dsp/synth/UnisonOscillator.h"
+#include "model/SynthVoiceParameters.h"
 #include <JuceHeader.h>
+#include <array>
 
 //==============================================================================
 
@@ -47,7 +52,16 @@ namespace synth {
  */
 class alignas(64) SynthVoice : public juce::SynthesiserVoice
 {
+  using AnalogOscillator = dmt::dsp::synth::AnalogOscillator;
+  using ControlRateModulator = dmt::dsp::envelope::ControlRateModulator;
+
+  // Number of samples the oscillator stack renders at once
+  static constexpr int renderChunkSize = 256;
+
 public:
+  using EventQueue = dmt::dsp::data::EventQueue<>;
+  using Event = dmt::dsp::data::ProcessorEvent;
+
   //==============================================================================
   /**
    * @brief Constructor for SynthVoice.
@@ -118,13 +132,38 @@ public:
     if (_sampleRate <= 0)
       return;
 
+    // Look the parameters up once, so renderNextBlock() doesn't have to
+    parameters.resolve(dmt::model::ParameterRegistry(apvts));
+
     gainEnvelope.setSampleRate(static_cast<float>(_sampleRate));
     pitchEnvelope.setSampleRate(static_cast<float>(_sampleRate));
     osc.setSampleRate(static_cast<float>(_sampleRate));
 
+    sampleClock = 0;
     isPrepared = true;
   }
 
+  //==============================================================================
+  /**
+   * @brief Sets whether the pitch envelope runs at audio or control rate.
+   * @param _quality AudioRate evaluates getNextFrequency() for every sample.
+   */
+  void setModulationQuality(
+    const ControlRateModulator::Quality _quality) noexcept
+  {
+    pitchModulator.setQuality(_quality);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets the number of samples between two pitch evaluations.
+   * @param _interval The interval used at control rate.
+   */
+  void setControlInterval(const int _interval) noexcept
+  {
+    pitchModulator.setInterval(_interval);
+  }
+
   //==============================================================================
   /**
    * @brief Starts a note.
@@ -134,25 +173,38 @@ public:
    * @param _currentPitchWheelPosition The current pitch wheel position.
    */
   void startNote(int _midiNoteNumber,
-                 float /*_velocity*/,
+                 float _velocity,
                  juce::SynthesiserSound* /*_sound*/,
                  int /*_currentPitchWheelPosition*/) noexcept override
   {
     TRACER("SynthVoice::startNote");
-    osc.setPhase(0.0f);
+    if (isPrepared)
+      osc.setParameters(parameters.voicing);
+    osc.reset();
     note = _midiNoteNumber;
 
     updateEnvelopeParameters();
     gainEnvelope.noteOn();
     pitchEnvelope.noteOn();
 
-    callOnNoteReceivers();
+    pushNoteOn(_velocity);
   }
 
   //==============================================================================
-  void stopNote(float /*_velocity*/, bool /*_allowTailOff*/) noexcept override
+  /**
+   * @brief Stops the note.
+   * @param _velocity The release velocity.
+   * @param _allowTailOff Whether the note may ring out.
+   *
+   * @details
+   * The gain envelope has no release, so a tail-off lets it play to the end
+   * and renderNextBlock() frees the voice once it is idle.
+   */
+  void stopNote(float /*_velocity*/, bool _allowTailOff) noexcept override
   {
     TRACER("SynthVoice::stopNote");
+    if (!_allowTailOff)
+      clearCurrentNote();
   }
 
   /**
@@ -166,104 +218,128 @@ public:
                        int _numSamples) noexcept override
   {
     TRACER("SynthVoice::renderNextBlock");
+    // Counted for every voice, so a note-on knows where it starts
+    sampleClock += _numSamples;
+
     if (!isVoiceActive() || !isPrepared)
       return;
 
     updateEnvelopeParameters();
     updateOscillatorParameters();
 
-    const float oscGain =
-      apvts.getRawParameterValue("osc1DistortionPreGain")->load();
-    const int oscOctave = apvts.getRawParameterValue("osc1VoiceOctave")->load();
-    const int oscSemitone =
-      apvts.getRawParameterValue("osc1VoiceSemitone")->load();
-    const float oscModDepth =
-      apvts.getRawParameterValue("osc1PitchEnvDepth")->load();
-
-    const auto endSample = _numSamples + _startSample;
-    auto* leftChannel = _outputBuffer.getWritePointer(0);
-    auto* rightChannel = _outputBuffer.getWritePointer(1);
-
-    for (int sample = _startSample; sample < endSample; ++sample) {
-      osc.setFrequency(getNextFrequency(oscOctave, oscSemitone, oscModDepth));
-      const auto rawSample = osc.getNextSample();
-      const auto gainedSample = applyGain(rawSample, oscGain);
-      leftChannel[sample] = gainedSample;
-      rightChannel[sample] = gainedSample;
+    const float oscGain = parameters.distortion.preGain.load();
+    const int oscOctave = parameters.voicing.octave.load();
+    const int oscSemitone = parameters.voicing.semitone.load();
+    const float oscModDepth = parameters.pitchDepth.load();
+
+    auto* leftChannel = _outputBuffer.getWritePointer(0, _startSample);
+    auto* rightChannel = _outputBuffer.getWritePointer(1, _startSample);
+
+    std::array<float, renderChunkSize> frequencies;
+    std::array<float, renderChunkSize> gains;
+    std::array<float, renderChunkSize> voiceLeft;
+    std::array<float, renderChunkSize> voiceRight;
+
+    for (int start = 0; start < _numSamples; start += renderChunkSize) {
+      const int chunkSize = std::min(renderChunkSize, _numSamples - start);
+      float* left = leftChannel + start;
+      float* right = rightChannel + start;
+
+      if (pitchModulator.isAudioRate()) {
+        for (int i = 0; i < chunkSize; ++i) {
+          frequencies[i] =
+            getNextFrequency(oscOctave, oscSemitone, oscModDepth);
+        }
+      } else {
+        renderFrequencies(
+          frequencies.data(), chunkSize, oscOctave, oscSemitone, oscModDepth);
+      }
+
+      osc.renderBlock(
+        voiceLeft.data(), voiceRight.data(), frequencies.data(), chunkSize);
+
+      renderGains(gains.data(), chunkSize, oscGain);
+
+      // The other voices of the synthesiser render into the same buffer
+      for (int i = 0; i < chunkSize; ++i) {
+        left[i] += voiceLeft[i] * gains[i];
+        right[i] += voiceRight[i] * gains[i];
+      }
+
+      if (gainEnvelope.isIdle()) {
+        clearCurrentNote();
+        return;
+      }
     }
   }
 
   //==============================================================================
   /**
-   * @brief Adds a callback function to be called when a note is received.
-   * @param _callbackFunction The callback function.
+   * @brief Sets the queue the voice reports its note-ons to.
+   * @param _eventQueue The queue of the processor, or nullptr for none.
+   *
+   * @details
+   * All voices of a synthesiser run on the audio thread, so they can share
+   * the single producer side of one queue.
    */
-  void addOnNoteReceivers(std::function<void()> _callbackFunction) noexcept
+  void setEventQueue(EventQueue* _eventQueue) noexcept
   {
-    TRACER("SynthVoice::addOnNoteReceivers");
-    onNoteReceivers.push_back(std::move(_callbackFunction));
+    TRACER("SynthVoice::setEventQueue");
+    eventQueue = _eventQueue;
   }
 
   //==============================================================================
   /**
-   * @brief Calls all registered note receiver callback functions.
+   * @brief Reports a note-on to the event queue.
+   * @param _velocity The velocity of the note.
    */
-  void callOnNoteReceivers() noexcept
+  void pushNoteOn(float _velocity) noexcept
   {
-    TRACER("SynthVoice::callOnNoteReceivers");
-    for (const auto& func : onNoteReceivers) {
-      func();
-    }
+    TRACER("SynthVoice::pushNoteOn");
+    if (eventQueue != nullptr)
+      eventQueue->push({ Event::Type::NoteOn, sampleClock, note, _velocity });
   }
 
 protected:
   //==============================================================================
   /**
-   * @brief Updates the envelope parameters from the
-   * AudioProcessorValueTreeState.
+   * @brief Updates the envelope parameters through the resolved handles.
    */
   void updateEnvelopeParameters() noexcept
   {
     TRACER("SynthVoice::updateEnvelopeParameters");
     dmt::dsp::envelope::AhdEnvelope::Parameters gainEnvParameters;
-    gainEnvParameters.attack =
-      apvts.getRawParameterValue("osc1GainEnvAttack")->load();
-    gainEnvParameters.hold =
-      apvts.getRawParameterValue("osc1GainEnvHold")->load();
-    gainEnvParameters.decay =
-      apvts.getRawParameterValue("osc1GainEnvDecay")->load();
-    gainEnvParameters.decaySkew =
-      apvts.getRawParameterValue("osc1GainEnvSkew")->load();
-    gainEnvParameters.attackSkew = 0;
+    gainEnvParameters.attack = parameters.gainAttack.load();
+    gainEnvParameters.hold = parameters.gainHold.load();
+    gainEnvParameters.decay = parameters.gainDecay.load();
+    gainEnvParameters.decayBend = parameters.gainSkew.load();
+    gainEnvParameters.attackBend = 0;
     gainEnvelope.setParameters(gainEnvParameters);
 
     dmt::dsp::envelope::AhdEnvelope::Parameters pitchEnvParameters;
     pitchEnvParameters.attack = 0;
-    pitchEnvParameters.hold =
-      apvts.getRawParameterValue("osc1PitchEnvHold")->load();
-    pitchEnvParameters.decay =
-      apvts.getRawParameterValue("osc1PitchEnvDecay")->load();
-    pitchEnvParameters.decaySkew =
-      apvts.getRawParameterValue("osc1PitchEnvSkew")->load();
-    pitchEnvParameters.attackSkew = 0;
+    pitchEnvParameters.hold = parameters.pitchHold.load();
+    pitchEnvParameters.decay = parameters.pitchDecay.load();
+    pitchEnvParameters.decayBend = parameters.pitchSkew.load();
+    pitchEnvParameters.attackBend = 0;
     pitchEnvelope.setParameters(pitchEnvParameters);
   }
 
   //==============================================================================
   /**
-   * @brief Updates the oscillator parameters from the
-   * AudioProcessorValueTreeState.
+   * @brief Updates the oscillator parameters through the resolved handles.
    */
   void updateOscillatorParameters() noexcept
   {
     TRACER("SynthVoice::updateOscillatorParameters");
-    osc.setWaveformType(static_cast<dmt::dsp::synth::AnalogWaveform::Type>(
-      apvts.getRawParameterValue("osc1WaveformType")->load()));
-    osc.setDrive(apvts.getRawParameterValue("osc1DistortionType")->load());
-    osc.setBias(apvts.getRawParameterValue("osc1DistortionSymmetry")->load());
-    osc.setBend(apvts.getRawParameterValue("osc1WaveformBend")->load());
-    osc.setPwm(apvts.getRawParameterValue("osc1WaveformPwm")->load());
-    osc.setSync(apvts.getRawParameterValue("osc1WaveformSync")->load());
+    auto& shaper = osc.getOscillator();
+    shaper.setWaveformType(parameters.waveform.type.load());
+    shaper.setDrive(static_cast<float>(parameters.distortion.type.load()));
+    shaper.setBias(parameters.distortion.symmetry.load());
+    shaper.setBend(parameters.waveform.bend.load());
+    shaper.setPwm(parameters.waveform.pwm.load());
+    shaper.setSync(parameters.waveform.sync.load());
+    osc.setParameters(parameters.voicing);
   }
 
   //==============================================================================
@@ -292,27 +368,74 @@ protected:
 
   //==============================================================================
   /**
-   * @brief Applies gain to a sample.
-   * @param _sample The input sample.
+   * @brief Renders the frequencies of a block at control rate.
+   * @param _frequencies The buffer the frequencies are written to.
+   * @param _numSamples The number of samples.
+   * @param _rawOctave The raw octave value.
+   * @param _rawSemitone The raw semitone value.
+   * @param _rawModDepth The raw modulation depth.
+   *
+   * @details
+   * Evaluates the same pitch as getNextFrequency(), but only once per
+   * control interval, and moves the pitch envelope past the block.
+   */
+  void renderFrequencies(float* _frequencies,
+                         const int _numSamples,
+                         const int _rawOctave,
+                         const int _rawSemitone,
+                         const float _rawModDepth) noexcept
+  {
+    TRACER("SynthVoice::renderFrequencies");
+    const int octaves = 12 * _rawOctave;
+    const int semitone = octaves + _rawSemitone;
+    const int baseNote = note + semitone;
+    const auto baseFreq =
+      static_cast<float>(juce::MidiMessage::getMidiNoteInHertz(baseNote));
+    const float modDepth = _rawModDepth * 2e4f;
+    const float maxFreq = std::clamp(baseFreq + modDepth, baseFreq, 2e4f);
+    const auto kernel = pitchEnvelope.getKernel();
+
+    const auto startIndex = static_cast<float>(pitchEnvelope.getSampleIndex());
+    pitchModulator.render(
+      _frequencies, _numSamples, startIndex, [&](const float _index) {
+        const float envelopeSample = kernel.getValue(_index);
+        const float newFreq =
+          juce::mapToLog10(envelopeSample, baseFreq, maxFreq);
+        return std::clamp(newFreq, 20.0f, 2e4f);
+      });
+
+    pitchEnvelope.skip(static_cast<size_t>(_numSamples));
+  }
+
+  //==============================================================================
+  /**
+   * @brief Renders the gain of the next block.
+   * @param _gains The buffer the gains are written to.
+   * @param _numSamples The number of samples.
    * @param _oscGain The oscillator gain.
-   * @return The gained sample.
    */
-  [[nodiscard]] float applyGain(float _sample, float _oscGain) noexcept
+  void renderGains(float* _gains, int _numSamples, float _oscGain) noexcept
   {
-    TRACER("SynthVoice::applyGain");
-    const float envGain = gainEnvelope.getNextSample();
+    TRACER("SynthVoice::renderGains");
+    gainEnvelope.renderBlock(_gains, _numSamples);
     const float gain = juce::Decibels::decibelsToGain(_oscGain, -96.0f);
-    return _sample * envGain * gain;
+    for (int i = 0; i < _numSamples; ++i) {
+      _gains[i] *= gain;
+    }
   }
 
 private:
   juce::AudioProcessorValueTreeState& apvts;
-  dmt::dsp::synth::AnalogOscillator osc;
+  dmt::model::SynthVoiceParameterHandles parameters;
+  dmt::dsp::synth::UnisonOscillator<AnalogOscillator> osc;
   dmt::dsp::envelope::AhdEnvelope gainEnvelope;
   dmt::dsp::envelope::AhdEnvelope pitchEnvelope;
+  ControlRateModulator pitchModulator;
   int note = 0;
   bool isPrepared = false;
-  std::vector<std::function<void()>> onNoteReceivers;
+  EventQueue* eventQueue = nullptr;
+  // Samples the synthesiser has rendered, whether this voice played or not
+  std::int64_t sampleClock = 0;
 };
 
 //==============================================================================
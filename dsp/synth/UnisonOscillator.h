@@ -0,0 +1,327 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Unison engine that stacks detuned copies of an oscillator in SIMD lanes.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "dsp/noise/NoiseGenerator.h"
+#include "model/VoicingParameters.h"
+#include "utility/FastMath.h"
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace synth {
+
+//==============================================================================
+/**
+ * @class UnisonOscillator
+ * @brief Stacks detuned copies of an oscillator and spreads them in stereo.
+ *
+ * @details
+ * Only the phases are per voice. They are stored as structure-of-arrays,
+ * one lane per voice, next to the detune ratios and the pan gains of every
+ * lane. Each sample advances all lanes in one branch-free loop, and a chunk
+ * of lane phases is shaped by a single renderPhases() call of the one
+ * wrapped oscillator. This way a dense stack only adds the phase updates and
+ * the lookups, not the parameter handling or the shaping setup of extra
+ * oscillators.
+ *
+ * The voices are placed evenly between -1 and +1. Distribution pulls the
+ * detune of the inner voices towards the center, Width pans the outer voices
+ * to the sides, and Blend sets the level of all but the center voices. The
+ * start phases come from Seed, Random and Phase, so a patch sounds the same
+ * every time a note starts.
+ *
+ * @tparam OscillatorType The oscillator shaping the phases, e.g.
+ * DigitalOscillator or AnalogOscillator.
+ * @tparam MaxVoices The maximum number of stacked voices.
+ */
+template<typename OscillatorType, int MaxVoices = 16>
+class alignas(64) UnisonOscillator
+{
+  static_assert(MaxVoices > 0, "UnisonOscillator needs at least one voice.");
+
+  static constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+  // Number of samples whose lane phases are shaped at once
+  static constexpr int chunkSize = 64;
+
+public:
+  //==============================================================================
+  /**
+   * @brief The voicing, in the units of the Voicing parameters.
+   */
+  struct Parameters
+  {
+    int density = 1;           // Number of voices
+    float detune = 0.0f;       // Detune of the outermost voices in cents
+    float distribution = 0.0f; // 0 to 100 percent
+    float width = 100.0f;      // 0 to 100 percent
+    float blend = 100.0f;      // 0 to 100 percent
+    int seed = 0;
+    float random = 100.0f; // 0 to 100 percent of a cycle
+    float phase = 0.0f;    // 0 to 360 degrees
+
+    bool operator==(const Parameters& _other) const noexcept
+    {
+      return density == _other.density && detune == _other.detune &&
+             distribution == _other.distribution && width == _other.width &&
+             blend == _other.blend && seed == _other.seed &&
+             random == _other.random && phase == _other.phase;
+    }
+  };
+
+  //==============================================================================
+  UnisonOscillator() noexcept { updateVoices(); }
+
+  //==============================================================================
+  /**
+   * @brief Gives access to the oscillator shaping all voices.
+   */
+  [[nodiscard]] inline OscillatorType& getOscillator() noexcept
+  {
+    return oscillator;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets the sample rate of the stack and the oscillator.
+   * @param _newSampleRate The new sample rate in Hz.
+   */
+  inline void setSampleRate(const float _newSampleRate) noexcept
+  {
+    TRACER("UnisonOscillator::setSampleRate");
+    sampleRate = _newSampleRate;
+    oscillator.setSampleRate(_newSampleRate);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets the voicing. Only recomputes the lanes if it changed.
+   * @param _parameters The new voicing.
+   */
+  inline void setParameters(const Parameters& _parameters) noexcept
+  {
+    TRACER("UnisonOscillator::setParameters");
+    if (_parameters == parameters)
+      return;
+
+    parameters = _parameters;
+    updateVoices();
+  }
+
+  //==============================================================================
+  /**
+   * @brief Sets the voicing through the resolved Voicing parameters.
+   * @param _handles The resolved handles.
+   */
+  inline void setParameters(
+    const dmt::model::VoicingParameterHandles& _handles) noexcept
+  {
+    Parameters newParameters;
+    newParameters.density = _handles.density.load();
+    newParameters.detune = _handles.detune.load();
+    newParameters.distribution = _handles.distribution.load();
+    newParameters.width = _handles.width.load();
+    newParameters.blend = _handles.blend.load();
+    newParameters.seed = _handles.seed.load();
+    newParameters.random = _handles.random.load();
+    newParameters.phase = _handles.phase.load();
+    setParameters(newParameters);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Restarts every voice at its start phase.
+   *
+   * @details
+   * All voices start at Phase, and each is moved by up to Random of a cycle
+   * by noise generated from Seed.
+   */
+  inline void reset() noexcept
+  {
+    TRACER("UnisonOscillator::reset");
+
+    std::array<float, MaxVoices> offsets;
+    const dmt::dsp::noise::NoiseGenerator noise(
+      static_cast<std::uint64_t>(parameters.seed));
+    noise.fill(offsets.data(), MaxVoices, 0, 0.0f, 1.0f);
+
+    const float startPhase = parameters.phase / 360.0f;
+    const float randomness = parameters.random / 100.0f;
+    for (int voice = 0; voice < MaxVoices; ++voice) {
+      const float cycles = startPhase + randomness * offsets[voice];
+      phases[voice] = (cycles - std::floor(cycles)) * twoPi;
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Renders a block of the whole stack.
+   * @param _left The buffer the left channel is written to.
+   * @param _right The buffer the right channel is written to.
+   * @param _frequency The frequency in Hz for every sample.
+   * @param _numSamples The number of samples.
+   */
+  inline void renderBlock(float* _left,
+                          float* _right,
+                          const float* _frequency,
+                          const int _numSamples) noexcept
+  {
+    TRACER("UnisonOscillator::renderBlock");
+
+    if (sampleRate <= 0.0f) {
+      std::fill(_left, _left + _numSamples, 0.0f);
+      std::fill(_right, _right + _numSamples, 0.0f);
+      return;
+    }
+
+    alignas(64) std::array<float, chunkSize * MaxVoices> lanePhases;
+    alignas(64) std::array<float, chunkSize * MaxVoices> laneSamples;
+    const float phaseScale = twoPi / sampleRate;
+
+    for (int start = 0; start < _numSamples; start += chunkSize) {
+      const int numFrames = std::min(chunkSize, _numSamples - start);
+      const float* frequency = _frequency + start;
+
+      // The lanes are independent, so this loop runs across all voices at once
+      for (int frame = 0; frame < numFrames; ++frame) {
+        const float phaseDelta = frequency[frame] * phaseScale;
+        float* framePhases = lanePhases.data() + frame * numVoices;
+        for (int voice = 0; voice < numVoices; ++voice) {
+          float phase = phases[voice] + phaseDelta * ratios[voice];
+          phase -= dmt::math::branchlessSelect(phase >= twoPi, twoPi, 0.0f);
+          phases[voice] = phase;
+          framePhases[voice] = phase;
+        }
+      }
+
+      const float highestFrequency =
+        *std::max_element(frequency, frequency + numFrames) * highestRatio;
+      oscillator.renderPhases(laneSamples.data(),
+                              lanePhases.data(),
+                              numFrames * numVoices,
+                              highestFrequency);
+
+      for (int frame = 0; frame < numFrames; ++frame) {
+        const float* frameSamples = laneSamples.data() + frame * numVoices;
+        float left = 0.0f;
+        float right = 0.0f;
+        for (int voice = 0; voice < numVoices; ++voice) {
+          left += frameSamples[voice] * leftGains[voice];
+          right += frameSamples[voice] * rightGains[voice];
+        }
+        _left[start + frame] = left;
+        _right[start + frame] = right;
+      }
+    }
+  }
+
+private:
+  //==============================================================================
+  /**
+   * @brief Computes the detune ratio and pan gains of every lane.
+   */
+  void updateVoices() noexcept
+  {
+    numVoices = std::clamp(parameters.density, 1, MaxVoices);
+
+    const float distributionExponent =
+      1.0f + 3.0f * std::clamp(parameters.distribution / 100.0f, 0.0f, 1.0f);
+    const float width = std::clamp(parameters.width / 100.0f, 0.0f, 1.0f);
+    const float blend = std::clamp(parameters.blend / 100.0f, 0.0f, 1.0f);
+
+    // Odd stacks have one center voice, even stacks have two
+    const float centerDistance = (numVoices % 2 == 0)
+                                   ? 1.0f / static_cast<float>(numVoices - 1)
+                                   : 0.0f;
+
+    float power = 0.0f;
+    highestRatio = 1.0f;
+    for (int voice = 0; voice < MaxVoices; ++voice) {
+      if (voice >= numVoices) {
+        ratios[voice] = 0.0f;
+        leftGains[voice] = 0.0f;
+        rightGains[voice] = 0.0f;
+        continue;
+      }
+
+      const float position =
+        numVoices == 1 ? 0.0f
+                       : -1.0f + 2.0f * static_cast<float>(voice) /
+                                   static_cast<float>(numVoices - 1);
+      const float spread =
+        std::copysign(std::pow(std::abs(position), distributionExponent),
+                      position);
+      ratios[voice] = std::exp2(parameters.detune * spread / 1200.0f);
+      highestRatio = std::max(highestRatio, ratios[voice]);
+
+      const bool isCenter = std::abs(position) <= centerDistance + 1e-6f;
+      const float gain = isCenter ? 1.0f : blend;
+      power += gain * gain;
+
+      // A centered voice plays at full level on both sides
+      const float pan = position * width;
+      leftGains[voice] = gain * std::min(1.0f, 1.0f - pan);
+      rightGains[voice] = gain * std::min(1.0f, 1.0f + pan);
+    }
+
+    // The voices are uncorrelated, so their powers add up
+    const float normalizer = 1.0f / std::sqrt(power);
+    for (int voice = 0; voice < numVoices; ++voice) {
+      leftGains[voice] *= normalizer;
+      rightGains[voice] *= normalizer;
+    }
+  }
+
+  //==============================================================================
+  OscillatorType oscillator;
+  Parameters parameters;
+  float sampleRate = -1.0f;
+  int numVoices = 1;
+  float highestRatio = 1.0f;
+
+  alignas(64) std::array<float, MaxVoices> phases{};
+  alignas(64) std::array<float, MaxVoices> ratios{};
+  alignas(64) std::array<float, MaxVoices> leftGains{};
+  alignas(64) std::array<float, MaxVoices> rightGains{};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UnisonOscillator)
+};
+
+//==============================================================================
+
+} // namespace synth
+} // namespace dsp
+} // namespace dmt
+
+//==============================================================================
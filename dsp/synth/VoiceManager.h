@@ -0,0 +1,283 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Fixed-size voice pool with structure-of-arrays voice state and stealing.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace synth {
+
+//==============================================================================
+/**
+ * @class VoiceManager
+ * @brief Assigns notes to a fixed pool of voices stored as lanes.
+ *
+ * @details
+ * Every voice is a lane in a set of arrays: the oscillator phase, the
+ * envelope index, the frequency of the note, a gate that is 1 while the
+ * voice plays and 0 otherwise, and the last gain level. A renderer can run
+ * all lanes through one loop, with the gate muting the free ones, instead of
+ * calling into each voice.
+ *
+ * The pool has room for MaxVoices voices. The polyphony limits how many of
+ * them are used, and when all of those play, a new note steals a voice
+ * according to the stealing policy. Nothing allocates after construction.
+ *
+ * @tparam MaxVoices The size of the pool.
+ */
+template<int MaxVoices>
+class alignas(64) VoiceManager
+{
+  static_assert(MaxVoices > 0, "VoiceManager needs at least one voice.");
+
+public:
+  static constexpr int capacity = MaxVoices;
+
+  /**
+   * @brief Which voice a note takes when all voices are playing.
+   */
+  enum class StealingPolicy
+  {
+    Oldest,   // The voice that started first
+    Quietest, // The voice with the lowest gain level
+    SameNote, // A voice playing the same note, otherwise the oldest
+  };
+
+  template<typename ValueType>
+  using Lanes = std::array<ValueType, MaxVoices>;
+
+  //==============================================================================
+  VoiceManager() noexcept { reset(); }
+
+  //==============================================================================
+  /**
+   * @brief Sets how many voices of the pool may play at once.
+   * @param _polyphony The number of voices, clamped to [1, MaxVoices].
+   */
+  inline void setPolyphony(const int _polyphony) noexcept
+  {
+    polyphony = std::clamp(_polyphony, 1, MaxVoices);
+    for (int voice = polyphony; voice < MaxVoices; ++voice) {
+      release(voice);
+    }
+  }
+
+  [[nodiscard]] inline int getPolyphony() const noexcept { return polyphony; }
+
+  //==============================================================================
+  inline void setStealingPolicy(const StealingPolicy _policy) noexcept
+  {
+    stealingPolicy = _policy;
+  }
+
+  [[nodiscard]] inline StealingPolicy getStealingPolicy() const noexcept
+  {
+    return stealingPolicy;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Frees all voices.
+   */
+  inline void reset() noexcept
+  {
+    for (int voice = 0; voice < MaxVoices; ++voice) {
+      release(voice);
+      phases[voice] = 0.0f;
+      envelopeIndices[voice] = 0.0f;
+      frequencies[voice] = 0.0f;
+      notes[voice] = -1;
+      ages[voice] = 0;
+    }
+    nextAge = 0;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Starts a note on a free or stolen voice.
+   * @param _note The MIDI note number.
+   * @param _frequency The frequency of the note in Hz.
+   * @param _velocity The velocity of the note.
+   * @return The voice playing the note.
+   */
+  inline int noteOn(const int _note,
+                    const float _frequency,
+                    const float _velocity = 1.0f) noexcept
+  {
+    const int voice = findVoice(_note);
+    phases[voice] = 0.0f;
+    envelopeIndices[voice] = 0.0f;
+    frequencies[voice] = _frequency;
+    velocities[voice] = _velocity;
+    gates[voice] = 1.0f;
+    levels[voice] = 0.0f;
+    notes[voice] = _note;
+    ages[voice] = ++nextAge;
+    return voice;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Frees a voice, so it is muted and can be taken by the next note.
+   */
+  inline void release(const int _voice) noexcept
+  {
+    jassert(_voice >= 0 && _voice < MaxVoices);
+    gates[_voice] = 0.0f;
+    levels[_voice] = 0.0f;
+    velocities[_voice] = 0.0f;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Frees the voices whose envelope has run out.
+   * @param _envelopeLength The envelope index from which a voice is silent.
+   */
+  inline void releaseFinished(const float _envelopeLength) noexcept
+  {
+    for (int voice = 0; voice < MaxVoices; ++voice) {
+      if (isActive(voice) && envelopeIndices[voice] >= _envelopeLength)
+        release(voice);
+    }
+  }
+
+  //==============================================================================
+  [[nodiscard]] inline bool isActive(const int _voice) const noexcept
+  {
+    return gates[_voice] > 0.0f;
+  }
+
+  [[nodiscard]] inline bool isAnyActive() const noexcept
+  {
+    for (int voice = 0; voice < MaxVoices; ++voice) {
+      if (isActive(voice))
+        return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]] inline int getNumActiveVoices() const noexcept
+  {
+    int count = 0;
+    for (int voice = 0; voice < MaxVoices; ++voice) {
+      count += isActive(voice) ? 1 : 0;
+    }
+    return count;
+  }
+
+  [[nodiscard]] inline int getNote(const int _voice) const noexcept
+  {
+    return notes[_voice];
+  }
+
+  //==============================================================================
+  // Lanes for renderers, indexed by voice
+  [[nodiscard]] inline Lanes<float>& getPhases() noexcept { return phases; }
+  [[nodiscard]] inline Lanes<float>& getEnvelopeIndices() noexcept
+  {
+    return envelopeIndices;
+  }
+  [[nodiscard]] inline Lanes<float>& getFrequencies() noexcept
+  {
+    return frequencies;
+  }
+  [[nodiscard]] inline Lanes<float>& getLevels() noexcept { return levels; }
+  [[nodiscard]] inline const Lanes<float>& getGates() const noexcept
+  {
+    return gates;
+  }
+  [[nodiscard]] inline const Lanes<float>& getVelocities() const noexcept
+  {
+    return velocities;
+  }
+
+private:
+  //==============================================================================
+  /**
+   * @brief Picks the voice for a new note.
+   */
+  [[nodiscard]] inline int findVoice(const int _note) const noexcept
+  {
+    if (stealingPolicy == StealingPolicy::SameNote) {
+      for (int voice = 0; voice < polyphony; ++voice) {
+        if (isActive(voice) && notes[voice] == _note)
+          return voice;
+      }
+    }
+
+    for (int voice = 0; voice < polyphony; ++voice) {
+      if (!isActive(voice))
+        return voice;
+    }
+
+    int stolen = 0;
+    for (int voice = 1; voice < polyphony; ++voice) {
+      const bool isQuieter = levels[voice] < levels[stolen];
+      const bool isAsQuiet = levels[voice] == levels[stolen];
+      const bool isOlder = ages[voice] < ages[stolen];
+      if (stealingPolicy == StealingPolicy::Quietest) {
+        if (isQuieter || (isAsQuiet && isOlder))
+          stolen = voice;
+      } else if (isOlder) {
+        stolen = voice;
+      }
+    }
+    return stolen;
+  }
+
+  //==============================================================================
+  alignas(64) Lanes<float> phases;
+  alignas(64) Lanes<float> envelopeIndices;
+  alignas(64) Lanes<float> frequencies;
+  alignas(64) Lanes<float> velocities;
+  alignas(64) Lanes<float> gates;
+  alignas(64) Lanes<float> levels;
+  Lanes<int> notes;
+  Lanes<std::uint64_t> ages;
+
+  std::uint64_t nextAge = 0;
+  int polyphony = MaxVoices;
+  StealingPolicy stealingPolicy = StealingPolicy::Oldest;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceManager)
+};
+
+//==============================================================================
+
+} // namespace synth
+} // namespace dsp
+} // namespace dmt
+
+//==============================================================================
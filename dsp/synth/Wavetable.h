@@ -0,0 +1,512 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Band-limited single cycle wavetables with mip levels, and a cache that
+ * shares them between oscillators with identical shaping parameters.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "utility/FastMath.h"
+#include <JuceHeader.h>
+#include <memory>
+#include <new>
+#include <vector>
+
+//==============================================================================
+
+namespace dmt {
+namespace dsp {
+namespace synth {
+
+//==============================================================================
+/**
+ * @class Wavetable
+ * @brief A single cycle waveform stored at several band limits.
+ *
+ * @details
+ * The cycle is transformed once, and every mip level is the inverse transform
+ * of the spectrum cut off at half the harmonics of the level before. Level 0
+ * keeps everything below the Nyquist frequency of the table, the last level
+ * keeps only the fundamental. Each level stores one guard sample past the end
+ * of the cycle so the linear interpolation never wraps.
+ */
+class alignas(64) Wavetable
+{
+  static constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+public:
+  static constexpr int order = 11;
+  static constexpr int size = 1 << order;
+  static constexpr int numLevels = order - 1;
+
+  //==============================================================================
+  /**
+   * @brief Builds all mip levels from a single cycle.
+   * @param _cycle The cycle, sampled at size equally spaced phases in [0, 2π).
+   */
+  explicit Wavetable(const float* _cycle)
+    : samples(static_cast<size_t>(numLevels * (size + 1)))
+  {
+    TRACER("Wavetable::Wavetable");
+
+    juce::dsp::FFT fft(order);
+    std::vector<float> spectrum(2 * size, 0.0f);
+    std::copy(_cycle, _cycle + size, spectrum.begin());
+    fft.performRealOnlyForwardTransform(spectrum.data());
+
+    std::vector<float> levelSpectrum(2 * size);
+    for (int level = 0; level < numLevels; ++level) {
+      levelSpectrum = spectrum;
+
+      // Everything above the highest harmonic of the level is removed,
+      // including the bin at the Nyquist frequency of the table
+      const int highestHarmonic = getHighestHarmonic(level);
+      for (int bin = highestHarmonic + 1; bin <= size / 2; ++bin) {
+        for (const int index : { bin, size - bin }) {
+          levelSpectrum[2 * index] = 0.0f;
+          levelSpectrum[2 * index + 1] = 0.0f;
+        }
+      }
+
+      fft.performRealOnlyInverseTransform(levelSpectrum.data());
+      float* levelSamples = getLevelPointer(level);
+      std::copy(
+        levelSpectrum.begin(), levelSpectrum.begin() + size, levelSamples);
+      levelSamples[size] = levelSamples[0];
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Returns the highest harmonic that is kept on a mip level.
+   */
+  [[nodiscard]] static constexpr int getHighestHarmonic(
+    const int _level) noexcept
+  {
+    return (size / 2 - 1) >> _level;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Picks the most detailed mip level that doesn't alias.
+   * @param _frequency The frequency in Hz.
+   * @param _sampleRate The sample rate in Hz.
+   * @return The mip level.
+   */
+  [[nodiscard]] static inline int getLevel(const float _frequency,
+                                           const float _sampleRate) noexcept
+  {
+    const float maxHarmonic = 0.5f * _sampleRate / std::abs(_frequency);
+    int level = 0;
+    while (level < numLevels - 1 &&
+           static_cast<float>(getHighestHarmonic(level)) > maxHarmonic) {
+      ++level;
+    }
+    return level;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Reads the table with linear interpolation.
+   * @param _level The mip level.
+   * @param _phase The phase, within [0, 2π).
+   * @return The interpolated sample.
+   */
+  [[nodiscard]] forcedinline float getSample(const int _level,
+                                             const float _phase) const noexcept
+  {
+    const float* levelSamples = getLevelPointer(_level);
+    const float position = _phase * (static_cast<float>(size) / twoPi);
+    // Rounding can push the position up to size, which wraps to the start
+    const int index = static_cast<int>(position) & (size - 1);
+    const float fraction = position - std::floor(position);
+    const float current = levelSamples[index];
+    return current + fraction * (levelSamples[index + 1] - current);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Reads the table for a block of phases.
+   * @param _output The buffer the samples are written to.
+   * @param _phases The phases, within [0, 2π).
+   * @param _numSamples The number of samples.
+   * @param _level The mip level.
+   */
+  inline void renderBlock(float* _output,
+                          const float* _phases,
+                          const int _numSamples,
+                          const int _level) const noexcept
+  {
+    for (int i = 0; i < _numSamples; ++i) {
+      _output[i] = getSample(_level, _phases[i]);
+    }
+  }
+
+private:
+  //==============================================================================
+  [[nodiscard]] forcedinline const float* getLevelPointer(
+    const int _level) const noexcept
+  {
+    jassert(_level >= 0 && _level < numLevels);
+    return samples.data() + _level * (size + 1);
+  }
+
+  [[nodiscard]] forcedinline float* getLevelPointer(const int _level) noexcept
+  {
+    jassert(_level >= 0 && _level < numLevels);
+    return samples.data() + _level * (size + 1);
+  }
+
+  //==============================================================================
+  std::vector<float> samples;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Wavetable)
+};
+
+//==============================================================================
+/**
+ * @class WavetableCache
+ * @brief Shares wavetables between oscillators with the same shaping.
+ *
+ * @details
+ * Tables are looked up by a key that holds every parameter the cycle depends
+ * on, so any number of voices with the same parameters share one copy. The
+ * cache holds a strong reference to every table, which means the last
+ * reference is never dropped by an oscillator on the audio thread.
+ * removeUnused() frees the tables nobody else holds anymore.
+ *
+ * Only meant to be used off the audio thread, as building allocates. The
+ * lock is held while building, so a table is never built twice.
+ *
+ * @tparam KeyType Equality comparable parameters the cycle is built from.
+ */
+template<typename KeyType>
+class WavetableCache
+{
+public:
+  using TablePointer = std::shared_ptr<const Wavetable>;
+  using BuildFunction = TablePointer (*)(const KeyType&);
+
+  WavetableCache() = default;
+
+  //==============================================================================
+  /**
+   * @brief Returns the table for a key, building it if it isn't cached.
+   * @param _key The parameters of the cycle.
+   * @param _buildTable Function returning a new TablePointer for the key.
+   * @return The table, or nullptr if it couldn't be allocated.
+   */
+  [[nodiscard]] TablePointer getOrBuild(const KeyType& _key,
+                                        BuildFunction _buildTable) noexcept
+  {
+    TRACER("WavetableCache::getOrBuild");
+
+    const juce::ScopedLock lock(mutex);
+    for (const auto& entry : entries) {
+      if (entry.key == _key)
+        return entry.table;
+    }
+
+    // Running out of memory just means the oscillator keeps its old table
+    try {
+      TablePointer table = _buildTable(_key);
+      entries.push_back({ _key, table });
+      return table;
+    } catch (const std::bad_alloc&) {
+      return nullptr;
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Frees every table only the cache still holds.
+   */
+  void removeUnused() noexcept
+  {
+    const juce::ScopedLock lock(mutex);
+    entries.erase(std::remove_if(entries.begin(),
+                                 entries.end(),
+                                 [](const Entry& _entry) {
+                                   return _entry.table.use_count() == 1;
+                                 }),
+                  entries.end());
+  }
+
+private:
+  //==============================================================================
+  struct Entry
+  {
+    KeyType key;
+    TablePointer table;
+  };
+
+  //==============================================================================
+  juce::CriticalSection mutex;
+  std::vector<Entry> entries;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableCache)
+};
+
+//==============================================================================
+/**
+ * @class WavetableBuilder
+ * @brief Builds wavetables on a background thread for the audio thread.
+ *
+ * @details
+ * Each oscillator owns a Request. On the audio thread it sets the key it
+ * wants and polls for the finished table, which it swaps in place of the one
+ * it plays. The old table goes back to the builder and is released there, so
+ * the audio thread never allocates, frees or waits. Until a table is ready
+ * the oscillator keeps playing the previous one. A request only remembers its
+ * latest key, so keys that change faster than tables are built are skipped.
+ *
+ * The audio thread doesn't wake the builder, as notify() locks a mutex. It
+ * only sets a flag, which the builder polls every pollInterval milliseconds.
+ *
+ * Use it through juce::SharedResourcePointer, which Request does, so there
+ * is one thread per key type and only while an oscillator needs it.
+ *
+ * @tparam KeyType Equality comparable parameters the cycle is built from.
+ */
+template<typename KeyType>
+class WavetableBuilder : private juce::Thread
+{
+public:
+  using TablePointer = std::shared_ptr<const Wavetable>;
+  using BuildFunction = typename WavetableCache<KeyType>::BuildFunction;
+
+  //==============================================================================
+  /**
+   * @brief The handoff between one oscillator and the builder.
+   */
+  class Request
+  {
+  public:
+    /**
+     * @brief Registers the request with the shared builder.
+     * @param _buildTable Function building the table for a key.
+     */
+    explicit Request(BuildFunction _buildTable)
+      : buildTable(_buildTable)
+    {
+      builder->add(*this);
+    }
+
+    ~Request() { builder->remove(*this); }
+
+    //==============================================================================
+    /**
+     * @brief Builds the table for a key right away.
+     * @param _key The parameters of the cycle.
+     * @param _table Receives the table, unless it couldn't be allocated.
+     *
+     * @details
+     * Allocates, so it must not be called on the audio thread. Anything
+     * requested before is dropped, so it can't replace the table later.
+     */
+    void buildNow(const KeyType& _key, TablePointer& _table) noexcept
+    {
+      auto table = builder->cache.getOrBuild(_key, buildTable);
+      if (table == nullptr)
+        return;
+
+      TablePointer stale;
+      {
+        const juce::SpinLock::ScopedLockType lock(handoffLock);
+        servedGeneration = ++pendingGeneration;
+        std::swap(stale, finished);
+      }
+      _table = std::move(table);
+      requestedKey = _key;
+      hasRequested = true;
+    }
+
+    //==============================================================================
+    /**
+     * @brief Asks for the table of a key to be built in the background.
+     * @param _key The parameters of the cycle.
+     *
+     * @details
+     * Does nothing when the key is already the latest request. If the builder
+     * holds the lock, the request is dropped and the caller simply tries
+     * again next time.
+     */
+    void request(const KeyType& _key) noexcept
+    {
+      if (hasRequested && _key == requestedKey)
+        return;
+
+      const juce::SpinLock::ScopedTryLockType lock(handoffLock);
+      if (!lock.isLocked())
+        return;
+
+      pendingKey = _key;
+      ++pendingGeneration;
+      requestedKey = _key;
+      hasRequested = true;
+      builder->workPending.store(true, std::memory_order_release);
+    }
+
+    //==============================================================================
+    /**
+     * @brief Swaps a finished table in, if there is one.
+     * @param _table The table the oscillator plays, replaced if one is ready.
+     *
+     * @details
+     * Neither allocates nor frees. The replaced table is handed back to the
+     * builder, which releases it on its own thread.
+     */
+    void takeFinished(TablePointer& _table) noexcept
+    {
+      const juce::SpinLock::ScopedTryLockType lock(handoffLock);
+      if (!lock.isLocked() || finished == nullptr || retired != nullptr)
+        return;
+
+      retired = std::move(_table);
+      _table = std::move(finished);
+      builder->workPending.store(true, std::memory_order_release);
+    }
+
+  private:
+    friend class WavetableBuilder;
+
+    const BuildFunction buildTable;
+    juce::SharedResourcePointer<WavetableBuilder> builder;
+
+    // Guarded by handoffLock
+    juce::SpinLock handoffLock;
+    KeyType pendingKey;
+    int pendingGeneration = 0;
+    int servedGeneration = 0;
+    TablePointer finished;
+    TablePointer retired;
+
+    // Only touched by the owner of the request
+    KeyType requestedKey;
+    bool hasRequested = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Request)
+  };
+
+  //==============================================================================
+  WavetableBuilder()
+    : Thread("WavetableBuilder")
+  {
+    startThread();
+  }
+
+  ~WavetableBuilder() override { stopThread(1000); }
+
+private:
+  //==============================================================================
+  void add(Request& _request)
+  {
+    const juce::ScopedLock lock(requestsLock);
+    requests.push_back(&_request);
+  }
+
+  //==============================================================================
+  void remove(Request& _request)
+  {
+    const juce::ScopedLock lock(requestsLock);
+    requests.erase(std::remove(requests.begin(), requests.end(), &_request),
+                   requests.end());
+  }
+
+  //==============================================================================
+  void run() override
+  {
+    while (!threadShouldExit()) {
+      wait(pollInterval);
+      if (!workPending.exchange(false, std::memory_order_acq_rel))
+        continue;
+
+      {
+        const juce::ScopedLock lock(requestsLock);
+        for (auto* request : requests) {
+          if (threadShouldExit())
+            return;
+          serve(*request);
+        }
+      }
+      cache.removeUnused();
+    }
+  }
+
+  //==============================================================================
+  /**
+   * @brief Collects the retired table of a request and builds its pending one.
+   */
+  void serve(Request& _request)
+  {
+    KeyType key;
+    int generation = 0;
+    TablePointer released;
+    {
+      const juce::SpinLock::ScopedLockType lock(_request.handoffLock);
+      std::swap(released, _request.retired);
+      if (_request.servedGeneration == _request.pendingGeneration)
+        return;
+      generation = _request.pendingGeneration;
+      _request.servedGeneration = generation;
+      key = _request.pendingKey;
+    }
+    released = nullptr;
+
+    TablePointer table = cache.getOrBuild(key, _request.buildTable);
+    if (table == nullptr)
+      return;
+
+    {
+      const juce::SpinLock::ScopedLockType lock(_request.handoffLock);
+      // A newer key came in while building, its table is built next time
+      if (_request.pendingGeneration == generation)
+        std::swap(table, _request.finished);
+    }
+    // Whatever is left here is an unclaimed table, released off the audio
+    // thread
+  }
+
+  //==============================================================================
+  // Milliseconds between two looks at workPending
+  static constexpr int pollInterval = 5;
+
+  WavetableCache<KeyType> cache;
+  juce::CriticalSection requestsLock;
+  std::vector<Request*> requests;
+  std::atomic<bool> workPending{ false };
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableBuilder)
+};
+
+//==============================================================================
+
+} // namespace synth
+} // namespace dsp
+} // namespace dmt
+
+//==============================================================================
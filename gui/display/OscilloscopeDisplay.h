@@ -31,10 +31,12 @@
 
 //==============================================================================
 
+#include "dsp/data/EventQueue.h"
 #include "dsp/data/FifoAudioBuffer.h"
 #include "dsp/data/RingAudioBuffer.h"
 #include "gui/display/AbstractDisplay.h"
 #include "gui/widget/Oscilloscope.h"
+#include "gui/widget/RenderWorker.h"
 #include "utility/RepaintTimer.h"
 #include "utility/Settings.h"
 #include <JuceHeader.h>
@@ -49,19 +51,28 @@ namespace display {
 template<typename SampleType>
 class OscilloscopeDisplay
   : public dmt::gui::display::AbstractDisplay
-  , public juce::AudioProcessorValueTreeState::Listener
+  , private dmt::gui::widget::RenderWorker::Job
 {
   using String = juce::String;
   using Oscilloscope = dmt::gui::widget::Oscilloscope<SampleType>;
+  using RenderWorker = dmt::gui::widget::RenderWorker;
   using RingAudioBuffer = dmt::dsp::data::RingAudioBuffer<SampleType>;
   using FifoAudioBuffer = dmt::dsp::data::FifoAudioBuffer<SampleType>;
+  using EventQueue = dmt::dsp::data::EventQueue<>;
+  using Event = dmt::dsp::data::ProcessorEvent;
   using Colour = juce::Colour;
   using Settings = dmt::Settings;
   using DisplaySettings = dmt::Settings::Display;
 
+  //==============================================================================
+  // One frame writes at most a quarter of the ring, the guard band, which
+  // covers 60 fps at up to 240 kHz
+  static constexpr int ringSize = 16384;
+
   //==============================================================================
   // General
   const Colour& backgroundColour = DisplaySettings::backgroundColour;
+  const Colour& traceColour = Settings::Oscilloscope::traceColour;
 
 public:
   //==============================================================================
@@ -69,42 +80,53 @@ public:
                       AudioProcessorValueTreeState& _apvts,
                       bool _useDefaultSettings = false)
     : apvts(_apvts)
-    , ringBuffer(2, 4096)
+    , ringBuffer(2, ringSize)
     , fifoBuffer(_fifoBuffer)
     , leftOscilloscope(ringBuffer, 0, size)
     , rightOscilloscope(ringBuffer, 1, size)
     , useDefaultSettings(_useDefaultSettings)
   {
     if (!useDefaultSettings) {
-      apvts.addParameterListener("OscilloscopeZoom", this);
-      apvts.addParameterListener("OscilloscopeThickness", this);
-      apvts.addParameterListener("OscilloscopeGain", this);
-      apvts.addParameterListener("OscilloscopeZoom", this);
-      apvts.addParameterListener("OscilloscopeThickness", this);
-      apvts.addParameterListener("OscilloscopeGain", this);
+      // Polled on the frame tick, as listeners would run on the audio thread
+      // whenever the host automates these parameters
+      zoomParameter = apvts.getRawParameterValue("OscilloscopeZoom");
+      thicknessParameter = apvts.getRawParameterValue("OscilloscopeThickness");
+      gainParameter = apvts.getRawParameterValue("OscilloscopeGain");
     } else {
       // Use default values from dmt::Settings::Oscilloscope
       setZoom(dmt::Settings::Oscilloscope::defaultZoom);
       setThickness(dmt::Settings::Oscilloscope::defaultThickness);
       setHeight(dmt::Settings::Oscilloscope::defaultGain);
     }
+
+    worker->add(*this);
   }
 
   ~OscilloscopeDisplay() override
   {
-    // Remove parameter listeners
-    if (!useDefaultSettings) {
-      // Assuming you have access to the AudioProcessorValueTreeState instance
-      // here, you would remove the listeners. This is just a placeholder.
-      apvts.removeParameterListener("OscilloscopeZoom", this);
-      apvts.removeParameterListener("OscilloscopeThickness", this);
-      apvts.removeParameterListener("OscilloscopeGain", this);
-    }
-
     // Stop the repaint timer
     stopRepaintTimer();
+    // Waits for a frame that is being rendered
+    worker->remove(*this);
   }
   //==============================================================================
+  /**
+   * @brief Sets the event queue of the processor this display shows.
+   *
+   * @param _eventQueue The queue, or nullptr for none.
+   *
+   * @details
+   * The display becomes the only consumer of the queue and drains it on every
+   * frame, handing each event to onEvent on the message thread.
+   */
+  void setEventQueue(EventQueue* _eventQueue) noexcept
+  {
+    eventQueue = _eventQueue;
+  }
+  //==============================================================================
+  // Called on the message thread for every event the processor reported
+  std::function<void(const Event&)> onEvent;
+  //==============================================================================
   void resized() noexcept override
   {
     auto displayBounds = getLocalBounds();
@@ -161,13 +183,14 @@ public:
                         rightBounds.getHeight());
 
     // Draw oscilloscope images
-    g.drawImageAt(leftOscilloscope.getFrontImage(),
-                  leftOscilloscope.getBounds().getX(),
-                  leftOscilloscope.getBounds().getY());
+    g.setColour(traceColour);
+    leftOscilloscope.drawTo(g,
+                            leftOscilloscope.getBounds().getX(),
+                            leftOscilloscope.getBounds().getY());
 
-    g.drawImageAt(rightOscilloscope.getFrontImage(),
-                  rightOscilloscope.getBounds().getX(),
-                  rightOscilloscope.getBounds().getY());
+    rightOscilloscope.drawTo(g,
+                             rightOscilloscope.getBounds().getX(),
+                             rightOscilloscope.getBounds().getY());
   }
 
 protected:
@@ -211,10 +234,21 @@ protected:
   void prepareNextFrame() noexcept override
   {
     TRACER("OscilloscopeDisplay::prepareNextFrame");
+    updateSettings();
+    drainEvents();
     ringBuffer.write(fifoBuffer);
     ringBuffer.equalizeReadPositions();
-    leftOscilloscope.notify();
-    rightOscilloscope.notify();
+    worker->request(*this);
+  }
+  //==============================================================================
+  /**
+   * @brief Renders both channels on the worker thread, as one job.
+   */
+  void renderFrame() override
+  {
+    TRACER("OscilloscopeDisplay::renderFrame");
+    leftOscilloscope.renderFrame();
+    rightOscilloscope.renderFrame();
   }
   //==============================================================================
   void setZoom(float _zoom) noexcept
@@ -244,17 +278,46 @@ protected:
     rightOscilloscope.setAmplitude(amplitude);
   }
   //==============================================================================
-  void parameterChanged(const String& _parameterID, float _newValue)
+  /**
+   * @brief Applies the parameters that changed since the last frame.
+   */
+  void updateSettings() noexcept
   {
-    if (_parameterID == "OscilloscopeZoom") {
-      setZoom(_newValue);
-    }
-    if (_parameterID == "OscilloscopeThickness") {
-      setThickness(_newValue);
-    }
-    if (_parameterID == "OscilloscopeGain") {
-      setHeight(_newValue);
-    }
+    if (useDefaultSettings)
+      return;
+
+    const float zoom = zoomParameter->load(std::memory_order_relaxed);
+    const float thickness = thicknessParameter->load(std::memory_order_relaxed);
+    const float gain = gainParameter->load(std::memory_order_relaxed);
+
+    if (zoom != lastZoom)
+      setZoom(zoom);
+    if (thickness != lastThickness)
+      setThickness(thickness);
+    if (gain != lastGain)
+      setHeight(gain);
+
+    lastZoom = zoom;
+    lastThickness = thickness;
+    lastGain = gain;
+  }
+  //==============================================================================
+  /**
+   * @brief Hands the events reported since the last frame to onEvent.
+   *
+   * @details
+   * Drained even without a callback, so the queue never fills up while the
+   * display is showing.
+   */
+  void drainEvents()
+  {
+    if (eventQueue == nullptr)
+      return;
+
+    eventQueue->drain([this](const Event& _event) {
+      if (onEvent)
+        onEvent(_event);
+    });
   }
   //==============================================================================
 private:
@@ -264,6 +327,14 @@ private:
   Oscilloscope leftOscilloscope;
   Oscilloscope rightOscilloscope;
   bool useDefaultSettings;
+  std::atomic<float>* zoomParameter = nullptr;
+  std::atomic<float>* thicknessParameter = nullptr;
+  std::atomic<float>* gainParameter = nullptr;
+  EventQueue* eventQueue = nullptr;
+  juce::SharedResourcePointer<RenderWorker> worker;
+  float lastZoom = std::numeric_limits<float>::quiet_NaN();
+  float lastThickness = std::numeric_limits<float>::quiet_NaN();
+  float lastGain = std::numeric_limits<float>::quiet_NaN();
 
   //==============================================================================
 
@@ -0,0 +1,385 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Oscilloscope renderer that rasterizes the waveform as anti-aliased vertical
+ * spans written straight into the image, without building or stroking a
+ * path.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "gui/widget/OscilloscopeRenderer.h"
+#include "utility/FastMath.h"
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+
+namespace dmt {
+namespace gui {
+namespace widget {
+
+//==============================================================================
+/**
+ * @brief Oscilloscope renderer that fills pixel columns directly.
+ *
+ * @tparam SampleType The sample type (e.g., float, double) used for audio data.
+ *
+ * @details
+ * Each pixel column gets the vertical range covered by the polyline through
+ * its samples, including the segments that cross in from its neighbours. The
+ * range is widened by half the stroke width and by the ranges of the columns
+ * within that distance, which gives round-ish caps and joins at any slope.
+ *
+ * The spans are then written row by row into Image::BitmapData with exact
+ * area coverage at their ends. The inner loop has no branches, so the
+ * compiler vectorizes it across columns. Pixels are combined with max, which
+ * is the same as blending because the scope only ever draws a single colour.
+ * Both the single channel images of the Oscilloscope and premultiplied ARGB
+ * images, drawn in white, are supported. This skips JUCE's path flattener
+ * and edge table, which do far more work than a function of x needs.
+ *
+ * The Graphics context is not used, the renderer writes to the image from the
+ * RenderContext instead. It keeps currentX and currentSample between frames
+ * just like the path based renderers.
+ */
+template<typename SampleType>
+class ColumnRenderer : public OscilloscopeRenderer<SampleType>
+{
+  //============================================================================
+public:
+  ColumnRenderer() = default;
+
+  //============================================================================
+public:
+  using RingBuffer = typename OscilloscopeRenderer<SampleType>::RingBuffer;
+  using RenderContext =
+    typename OscilloscopeRenderer<SampleType>::RenderContext;
+
+  //============================================================================
+  /**
+   * @brief Draws a waveform segment straight into the context's image.
+   *
+   * @param _ringBuffer Reference to the ring buffer containing audio samples.
+   * @param _channel The audio channel index to read from.
+   * @param _context Pre-computed rendering parameters for this frame.
+   */
+  inline void draw(juce::Graphics& /*_graphics*/,
+                   RingBuffer& _ringBuffer,
+                   int _channel,
+                   const RenderContext& _context) override
+  {
+    this->currentX = _context.drawStartX;
+    collectRanges(_ringBuffer, _channel, _context);
+    if (_context.image != nullptr)
+      fillSpans(*_context.image);
+  }
+
+  //============================================================================
+private:
+  // Bins with at least this many samples are read from the min/max pyramid
+  static constexpr size_t pyramidThreshold = 32;
+
+  // Marks a column without any waveform in it
+  static constexpr float empty = 1.0e30f;
+
+  // Columns filled together, four SSE or two AVX registers of pixels
+  static constexpr int tileWidth = 16;
+
+  //============================================================================
+  /**
+   * @brief Collects the vertical range of the waveform in each column.
+   *
+   * @details
+   * Consecutive samples in the same column form a bin, whose extremes come
+   * from the min/max pyramid when it is large. The segments between bins are
+   * split at the column boundaries. Updates currentX and currentSample.
+   */
+  inline void collectRanges(RingBuffer& _ringBuffer,
+                            int _channel,
+                            const RenderContext& _context)
+  {
+    const float startX = this->currentX;
+    const float pixelsPerSample = _context.pixelsPerSample;
+    const auto sampleCount = static_cast<size_t>(_context.sampleCount);
+    const float endX =
+      startX + static_cast<float>(sampleCount) * pixelsPerSample;
+
+    halfWidth = _context.thickness * _context.sizeFactor * 0.5f;
+    radius = static_cast<int>(halfWidth);
+    firstColumn = static_cast<int>(std::floor(startX)) - radius;
+    numColumns = static_cast<int>(std::floor(endX)) + radius + 1 - firstColumn;
+
+    if (lows.size() < static_cast<size_t>(numColumns)) {
+      lows.resize(static_cast<size_t>(numColumns));
+      highs.resize(static_cast<size_t>(numColumns));
+      tops.resize(static_cast<size_t>(numColumns));
+      bottoms.resize(static_cast<size_t>(numColumns));
+    }
+    std::fill_n(lows.begin(), numColumns, empty);
+    std::fill_n(highs.begin(), numColumns, -empty);
+
+    const auto toY = [&](const SampleType _sample) {
+      return this->sampleToY(_sample, _context.halfHeight, _context.amplitude);
+    };
+    const auto sampleX = [&](const size_t _index) {
+      return startX + static_cast<float>(_index + 1) * pixelsPerSample;
+    };
+    const auto columnOf = [](const float _x) {
+      return static_cast<int>(std::floor(_x));
+    };
+
+    float previousX = startX;
+    float previousY = toY(this->currentSample);
+    addRange(columnOf(previousX), previousY, previousY);
+
+    size_t binStart = 0;
+    while (binStart < sampleCount) {
+      const int column = columnOf(sampleX(binStart));
+
+      // The bin ends with the last sample before the next pixel column
+      size_t binLast = binStart;
+      if (pixelsPerSample < 1.0f) {
+        const float estimate =
+          std::ceil((float(column + 1) - startX) / pixelsPerSample) - 2.0f;
+        binLast = std::min(
+          static_cast<size_t>(std::max(estimate, float(binStart))),
+          sampleCount - 1);
+        while (binLast + 1 < sampleCount &&
+               columnOf(sampleX(binLast + 1)) == column)
+          ++binLast;
+        while (binLast > binStart && columnOf(sampleX(binLast)) > column)
+          --binLast;
+      }
+      const size_t binSize = binLast - binStart + 1;
+      const int firstIndex =
+        _context.firstSampleIndex + static_cast<int>(binStart);
+
+      const float firstY = toY(_ringBuffer.getSample(_channel, firstIndex));
+      addSegment(previousX, previousY, sampleX(binStart), firstY);
+
+      float lastY = firstY;
+      if (binSize > 1) {
+        const int lastIndex = firstIndex + static_cast<int>(binSize) - 1;
+        lastY = toY(_ringBuffer.getSample(_channel, lastIndex));
+
+        SampleType minSample, maxSample;
+        if (binSize >= pyramidThreshold) {
+          const auto extremes = _ringBuffer.getMinMax(
+            _channel, firstIndex, static_cast<int>(binSize));
+          minSample = extremes.min;
+          maxSample = extremes.max;
+        } else {
+          minSample = maxSample = _ringBuffer.getSample(_channel, firstIndex);
+          for (int i = firstIndex + 1; i <= lastIndex; ++i) {
+            const SampleType sample = _ringBuffer.getSample(_channel, i);
+            minSample = std::min(minSample, sample);
+            maxSample = std::max(maxSample, sample);
+          }
+        }
+        const float minY = toY(minSample);
+        const float maxY = toY(maxSample);
+        addRange(column, std::min(minY, maxY), std::max(minY, maxY));
+      }
+
+      previousX = sampleX(binLast);
+      previousY = lastY;
+      binStart = binLast + 1;
+    }
+
+    // Update persistent state for frame continuity
+    this->currentX = endX;
+    if (_context.sampleCount > 0) {
+      const int lastIndex =
+        _context.firstSampleIndex + _context.sampleCount - 1;
+      this->currentSample = _ringBuffer.getSample(_channel, lastIndex);
+    }
+  }
+
+  //============================================================================
+  /** @brief Widens the range of a column to include [_low, _high]. */
+  inline void addRange(const int _column,
+                       const float _low,
+                       const float _high) noexcept
+  {
+    // Rounding can put the ends of the frame one column outside
+    const int index = std::clamp(_column - firstColumn, 0, numColumns - 1);
+    lows[(size_t)index] = std::min(lows[(size_t)index], _low);
+    highs[(size_t)index] = std::max(highs[(size_t)index], _high);
+  }
+
+  //============================================================================
+  /** @brief Adds a line segment, split at the column boundaries it crosses. */
+  inline void addSegment(const float _x0,
+                         const float _y0,
+                         const float _x1,
+                         const float _y1) noexcept
+  {
+    const int first = static_cast<int>(std::floor(_x0));
+    const int last = static_cast<int>(std::floor(_x1));
+    if (first >= last) {
+      addRange(first, std::min(_y0, _y1), std::max(_y0, _y1));
+      return;
+    }
+
+    const float slope = (_y1 - _y0) / (_x1 - _x0);
+    float enterY = _y0;
+    for (int column = first; column < last; ++column) {
+      const float exitY = _y0 + (float(column + 1) - _x0) * slope;
+      addRange(column, std::min(enterY, exitY), std::max(enterY, exitY));
+      enterY = exitY;
+    }
+    addRange(last, std::min(enterY, _y1), std::max(enterY, _y1));
+  }
+
+  //============================================================================
+  /**
+   * @brief Writes the collected ranges into the image as anti-aliased spans.
+   *
+   * @param _image The image to draw into.
+   *
+   * @details
+   * Every column takes the union of the ranges within the stroke radius, then
+   * grows by half the stroke width. Coverage is the overlap of the span with
+   * each pixel row, so the ends of each span are anti-aliased. The columns are
+   * filled in narrow tiles, each only over the rows its spans reach.
+   */
+  inline void fillSpans(juce::Image& _image) noexcept
+  {
+    for (int column = 0; column < numColumns; ++column) {
+      const int from = std::max(column - radius, 0);
+      const int to = std::min(column + radius, numColumns - 1);
+      float low = empty;
+      float high = -empty;
+      for (int neighbour = from; neighbour <= to; ++neighbour) {
+        low = std::min(low, lows[(size_t)neighbour]);
+        high = std::max(high, highs[(size_t)neighbour]);
+      }
+      tops[(size_t)column] = low - halfWidth;
+      bottoms[(size_t)column] = high + halfWidth;
+    }
+
+    const int xStart = std::max(firstColumn, 0);
+    const int xEnd = std::min(firstColumn + numColumns, _image.getWidth());
+    if (xStart >= xEnd)
+      return;
+
+    juce::Image::BitmapData pixels(_image,
+                                   xStart,
+                                   0,
+                                   xEnd - xStart,
+                                   _image.getHeight(),
+                                   juce::Image::BitmapData::readWrite);
+    // Only single channel and 32 bit premultiplied ARGB images are supported
+    jassert(pixels.pixelStride == 1 || pixels.pixelStride == 4);
+
+    for (int tileStart = xStart; tileStart < xEnd; tileStart += tileWidth) {
+      const int width = std::min(tileWidth, xEnd - tileStart);
+      const float* const spanTops = tops.data() + (tileStart - firstColumn);
+      const float* const spanBottoms =
+        bottoms.data() + (tileStart - firstColumn);
+
+      float top = empty;
+      float bottom = -empty;
+      for (int x = 0; x < width; ++x) {
+        top = std::min(top, spanTops[x]);
+        bottom = std::max(bottom, spanBottoms[x]);
+      }
+
+      // Columns without samples keep their sentinels, nothing to fill
+      if (!(top <= bottom))
+        continue;
+
+      // Clamped before the conversion, spans can reach far past the image
+      const float height = static_cast<float>(_image.getHeight());
+      const int yStart =
+        static_cast<int>(std::floor(std::clamp(top, 0.0f, height)));
+      const int yEnd =
+        static_cast<int>(std::ceil(std::clamp(bottom, 0.0f, height)));
+
+      const int offset = tileStart - xStart;
+      if (pixels.pixelStride == 1)
+        fillRows<uint8_t>(
+          pixels, offset, spanTops, spanBottoms, width, yStart, yEnd);
+      else
+        fillRows<uint32_t>(
+          pixels, offset, spanTops, spanBottoms, width, yStart, yEnd);
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Fills the rows of one tile with the coverage of its spans.
+   *
+   * @tparam PixelType uint8_t for alpha images, uint32_t for ARGB images.
+   */
+  template<typename PixelType>
+  static inline void fillRows(const juce::Image::BitmapData& _pixels,
+                              const int _offset,
+                              const float* const _tops,
+                              const float* const _bottoms,
+                              const int _width,
+                              const int _yStart,
+                              const int _yEnd) noexcept
+  {
+    // The alpha in every channel is white, premultiplied
+    constexpr auto replicate = static_cast<PixelType>(0x01010101u);
+
+    for (int y = _yStart; y < _yEnd; ++y) {
+      auto* const line =
+        reinterpret_cast<PixelType*>(_pixels.getLinePointer(y)) + _offset;
+      const float rowTop = static_cast<float>(y);
+      const float rowBottom = rowTop + 1.0f;
+      for (int x = 0; x < _width; ++x) {
+        const float spanBottom = dmt::math::branchlessSelect(
+          _bottoms[x] < rowBottom, _bottoms[x], rowBottom);
+        const float spanTop =
+          dmt::math::branchlessSelect(_tops[x] > rowTop, _tops[x], rowTop);
+        const float coverage =
+          dmt::math::branchlessClamp(spanBottom - spanTop, 0.0f, 1.0f);
+        const auto alpha = static_cast<PixelType>(coverage * 255.0f + 0.5f);
+        const auto pixel = static_cast<PixelType>(alpha * replicate);
+        line[x] = line[x] > pixel ? line[x] : pixel;
+      }
+    }
+  }
+
+  //============================================================================
+  std::vector<float> lows;
+  std::vector<float> highs;
+  std::vector<float> tops;
+  std::vector<float> bottoms;
+  float halfWidth = 0.0f;
+  int radius = 0;
+  int firstColumn = 0;
+  int numColumns = 0;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ColumnRenderer)
+};
+
+} // namespace widget
+} // namespace gui
+} // namespace dmt
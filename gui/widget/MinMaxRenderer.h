@@ -104,6 +104,9 @@ public:
 
   //============================================================================
 private:
+  // Bins with at least this many samples are read from the min/max pyramid
+  static constexpr size_t pyramidThreshold = 32;
+
   //============================================================================
   /**
    * @brief Holds the min/max state for a single pixel column bin.
@@ -168,7 +171,9 @@ private:
    * the waveform's directional movement while reducing the point count to
    * at most two per pixel column.
    *
-   * When only one sample falls in a bin, a single point is drawn.
+   * When only one sample falls in a bin, a single point is drawn. Bins of
+   * many samples, at high zoom levels, take their extremes from the min/max
+   * pyramid of the ring buffer instead of scanning the samples.
    * The persistent currentX tracks the pixel column boundary for sub-pixel
    * continuity between frames.
    */
@@ -184,70 +189,69 @@ private:
                                          _context.halfHeight,
                                          _context.amplitude));
 
-    const float samplesPerPixel = 1.0f / _context.pixelsPerSample;
+    const float pixelsPerSample = _context.pixelsPerSample;
+    const auto sampleCount = static_cast<size_t>(_context.sampleCount);
     float nextBinBoundary = this->currentX + 1.0f;
+    float lastY = this->sampleToY(
+      this->currentSample, _context.halfHeight, _context.amplitude);
 
-    Bin bin;
-    bool binActive = false;
+    size_t binStart = 0;
+    while (binStart < sampleCount) {
+      // The bin ends with the last sample before the next pixel column
+      const float binEnd =
+        std::ceil((nextBinBoundary - this->currentX) / pixelsPerSample) - 2.0f;
+      const size_t binLast =
+        std::min(static_cast<size_t>(std::max(binEnd, float(binStart))),
+                 sampleCount - 1);
+      const size_t binSize = binLast - binStart + 1;
 
-    for (size_t i = 0; i < static_cast<size_t>(_context.sampleCount); ++i) {
-      const int sampleIndex = _context.firstSampleIndex + static_cast<int>(i);
-      const SampleType sample = _ringBuffer.getSample(_channel, sampleIndex);
       const float sampleX =
-        this->currentX + static_cast<float>(i + 1) * _context.pixelsPerSample;
-
-      if (!binActive) {
-        bin.reset(sample, i);
-        binActive = true;
-      } else {
-        bin.addSample(sample, i);
-      }
-
-      // Check if the next sample would cross into a new pixel column
+        this->currentX + static_cast<float>(binLast + 1) * pixelsPerSample;
       const float nextSampleX =
-        this->currentX + static_cast<float>(i + 2) * _context.pixelsPerSample;
-      const bool isLastSample =
-        (i + 1 >= static_cast<size_t>(_context.sampleCount));
+        this->currentX + static_cast<float>(binLast + 2) * pixelsPerSample;
       const bool crossesBoundary = (nextSampleX >= nextBinBoundary);
+      const float binX = std::min(sampleX, nextBinBoundary - 0.5f);
 
-      if (isLastSample || crossesBoundary) {
-        // Finalize the current bin
-        const float binX = std::min(sampleX, nextBinBoundary - 0.5f);
+      const int firstIndex =
+        _context.firstSampleIndex + static_cast<int>(binStart);
 
-        if (bin.count == 1) {
-          // Single sample in bin, draw one point
-          path.lineTo(binX,
-                      this->sampleToY(bin.minSample,
-                                      _context.halfHeight,
-                                      _context.amplitude));
-        } else {
-          // Multiple samples, draw min and max in temporal order
-          if (bin.minFirst()) {
-            path.lineTo(binX,
-                        this->sampleToY(bin.minSample,
-                                        _context.halfHeight,
-                                        _context.amplitude));
-            path.lineTo(binX,
-                        this->sampleToY(bin.maxSample,
-                                        _context.halfHeight,
-                                        _context.amplitude));
-          } else {
-            path.lineTo(binX,
-                        this->sampleToY(bin.maxSample,
-                                        _context.halfHeight,
-                                        _context.amplitude));
-            path.lineTo(binX,
-                        this->sampleToY(bin.minSample,
-                                        _context.halfHeight,
-                                        _context.amplitude));
-          }
-        }
-
-        if (crossesBoundary) {
-          nextBinBoundary = std::floor(nextSampleX) + 1.0f;
-          binActive = false;
+      float firstY, secondY;
+      if (binSize >= pyramidThreshold) {
+        // Too many samples to scan, the pyramid has their extremes but not
+        // their order, so the path goes to the nearer one first
+        const auto extremes = _ringBuffer.getMinMax(
+          _channel, firstIndex, static_cast<int>(binSize));
+        const float minY = this->sampleToY(
+          extremes.min, _context.halfHeight, _context.amplitude);
+        const float maxY = this->sampleToY(
+          extremes.max, _context.halfHeight, _context.amplitude);
+        const bool minNearer = std::abs(minY - lastY) <= std::abs(maxY - lastY);
+        firstY = minNearer ? minY : maxY;
+        secondY = minNearer ? maxY : minY;
+      } else {
+        Bin bin;
+        bin.reset(_ringBuffer.getSample(_channel, firstIndex), 0);
+        for (size_t i = 1; i < binSize; ++i) {
+          const int sampleIndex = firstIndex + static_cast<int>(i);
+          bin.addSample(_ringBuffer.getSample(_channel, sampleIndex), i);
         }
+        const float minY = this->sampleToY(
+          bin.minSample, _context.halfHeight, _context.amplitude);
+        const float maxY = this->sampleToY(
+          bin.maxSample, _context.halfHeight, _context.amplitude);
+        firstY = bin.minFirst() ? minY : maxY;
+        secondY = bin.minFirst() ? maxY : minY;
       }
+
+      // A bin of a single sample is a single point
+      path.lineTo(binX, firstY);
+      if (binSize > 1)
+        path.lineTo(binX, secondY);
+      lastY = binSize > 1 ? secondY : firstY;
+
+      if (crossesBoundary)
+        nextBinBoundary = std::floor(nextSampleX) + 1.0f;
+      binStart = binLast + 1;
     }
 
     // Update persistent state for frame continuity
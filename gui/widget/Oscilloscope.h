@@ -30,8 +30,10 @@
 
 //==============================================================================
 
+#include "gui/widget/ColumnRenderer.h"
 #include "gui/widget/MinMaxRenderer.h"
 #include "gui/widget/PathStrokeRenderer.h"
+#include "gui/widget/SimplifyingRenderer.h"
 #include <JuceHeader.h>
 
 //==============================================================================
@@ -48,20 +50,35 @@ namespace widget {
  *
  * @details
  * This class provides a high-performance oscilloscope visualization for audio
- * buffers, optimized for real-time use in GUI applications. It leverages a
- * background thread to render the waveform into a JUCE image, which can be
- * efficiently displayed in the GUI. The design ensures thread safety and
- * minimal overhead using lock-free double buffering for image access.
+ * buffers, optimized for real-time use in GUI applications. The shared
+ * RenderWorker renders the waveform into a JUCE image in the background,
+ * which can be efficiently displayed in the GUI.
+ *
+ * The image is a ring of pixel columns with a moving write head, so nothing is
+ * scrolled. Each frame only the newly arrived columns are rasterized, into a
+ * narrow strip that is copied into the ring. The GUI composites the ring with
+ * two blits in drawTo().
+ *
+ * There is a front and a back ring. The worker only writes the back ring and
+ * then swaps it to the front, so drawTo() never sees a frame half written.
+ * After the swap the same columns are copied into the new back ring, which
+ * keeps both rings in sync at the cost of the strip. A redrawn history is
+ * rendered into the back ring off-screen in the same way.
+ *
+ * The images only hold coverage, as single channel alpha, and are tinted with
+ * the trace colour when they are painted. That is a quarter of the memory and
+ * bandwidth of ARGB images.
  *
  * The oscilloscope is intended to be used with a lock-free ring buffer for
  * audio data, and supports customization of amplitude, thickness, and
  * samples-per-pixel for flexible display scaling.
  *
- * The rendering thread is started upon construction and stopped on destruction.
- * The image is updated periodically, and can be retrieved via getFrontImage().
+ * The owner renders frames with renderFrame() from a RenderWorker job, which
+ * lets a display render all of its channels in one job. The image can be
+ * painted via drawTo().
  */
 template<typename SampleType>
-class alignas(64) Oscilloscope : public juce::Thread
+class alignas(64) Oscilloscope
 {
   //==============================================================================
 public:
@@ -69,57 +86,106 @@ public:
   using Image = juce::Image;
   using Graphics = juce::Graphics;
   using String = juce::String;
-  using Thread = juce::Thread;
   using PixelFormat = juce::Image::PixelFormat;
   using Settings = dmt::Settings;
   using Renderer = OscilloscopeRenderer<SampleType>;
 
   //==============================================================================
   /**
-   * @brief Constructs the oscilloscope and starts the rendering thread.
+   * @brief Constructs the oscilloscope and registers it with the ring buffer.
    *
    * @param _ringBuffer Reference to the ring buffer containing audio samples.
    * @param _channel The audio channel to visualize.
    *
    * @details
-   * The rendering thread is started immediately. The oscilloscope will read
-   * from the provided ring buffer and visualize the specified channel.
+   * The oscilloscope will read from the provided ring buffer and visualize
+   * the specified channel once frames are rendered. If the ring buffer has
+   * no reader slot left, the oscilloscope stays blank.
    */
   explicit Oscilloscope(RingBuffer& _ringBuffer,
                         const int32_t _channel,
                         const float& _sizeFactor) noexcept
-    : Thread(String("Oscilloscope" + juce::String(_channel)))
-    , ringBuffer(_ringBuffer)
+    : ringBuffer(_ringBuffer)
+    , reader(_ringBuffer.addReader())
     , channel(_channel)
     , size(_sizeFactor)
     , renderer(std::make_shared<MinMaxRenderer<SampleType>>())
   {
-    startThread();
   }
 
   //==============================================================================
   /**
-   * @brief Destructor. Stops the rendering thread.
+   * @brief Renders one frame on the worker thread.
    *
    * @details
-   * Ensures the rendering thread is stopped gracefully before destruction.
+   * Updates the oscilloscope image by rendering the latest audio samples
+   * into the columns after the write head. Pending resizes and redraws of
+   * the history are handled first. Must not run concurrently with itself.
    */
-  inline ~Oscilloscope() noexcept override { stopThread(1000); }
+  inline void renderFrame()
+  {
+    // The ring buffer had no reader slot left
+    if (reader == RingBuffer::invalidReader)
+      return;
+
+    if (resizePending.exchange(false, std::memory_order_acq_rel)) {
+      resizeImage(renderWidth.load(std::memory_order_relaxed),
+                  renderHeight.load(std::memory_order_relaxed));
+      historyPending.store(true, std::memory_order_relaxed);
+    }
+
+    if (historyPending.exchange(false, std::memory_order_acq_rel))
+      renderHistory();
+    else
+      render();
+  }
 
   //==============================================================================
   /**
-   * @brief Retrieves the current front image for GUI rendering.
+   * @brief Paints the ring image in display order.
    *
-   * @return A reference to the front buffer image.
+   * @param _graphics The GUI graphics context.
+   * @param _x The left edge to paint at.
+   * @param _y The top edge to paint at.
    *
    * @details
-   * The render thread only writes to the back buffer, so the front image is
-   * safe for concurrent GUI reads.
+   * The columns from the write head to the end of the ring are the oldest,
+   * so they are drawn first, followed by the columns before the head. The
+   * alpha image is filled with the current colour of the graphics context.
+   * The front ring is held for the two blits, the worker only waits on it to
+   * swap the rings.
    */
-  [[nodiscard]] inline const juce::Image& getFrontImage() const noexcept
+  inline void drawTo(Graphics& _graphics, const int _x, const int _y) const
   {
-    const int frontIndex = frontBufferIndex.load(std::memory_order_acquire);
-    return images[static_cast<size_t>(frontIndex)];
+    const juce::SpinLock::ScopedLockType lock(frameLock);
+    const Image& image = frames[front].image;
+
+    const int ringWidth = image.getWidth();
+    const int ringHeight = image.getHeight();
+    const int head = jmin(frames[front].head, ringWidth);
+    const int oldWidth = ringWidth - head;
+
+    _graphics.drawImage(image,
+                        _x,
+                        _y,
+                        oldWidth,
+                        ringHeight,
+                        head,
+                        0,
+                        oldWidth,
+                        ringHeight,
+                        true);
+    if (head > 0)
+      _graphics.drawImage(image,
+                          _x + oldWidth,
+                          _y,
+                          head,
+                          ringHeight,
+                          0,
+                          0,
+                          head,
+                          ringHeight,
+                          true);
   }
 
   //==============================================================================
@@ -158,11 +224,16 @@ public:
    * @param _newRawSamplesPerPixel The new samples-per-pixel value.
    *
    * @details
-   * Adjusts the horizontal scaling of the waveform.
+   * Adjusts the horizontal scaling of the waveform. The history in the ring
+   * buffer is drawn again at the new scale on the next frame, so the image
+   * doesn't wait for new audio to fill up.
    */
   inline void setRawSamplesPerPixel(float _newRawSamplesPerPixel) noexcept
   {
-    rawSamplesPerPixel.store(_newRawSamplesPerPixel, std::memory_order_relaxed);
+    const float previous = rawSamplesPerPixel.exchange(
+      _newRawSamplesPerPixel, std::memory_order_relaxed);
+    if (previous != _newRawSamplesPerPixel)
+      historyPending.store(true, std::memory_order_release);
   }
 
   //==============================================================================
@@ -216,37 +287,87 @@ public:
 protected:
   //==============================================================================
   /**
-   * @brief Main rendering thread loop.
+   * @brief A ring image with its write head.
+   */
+  struct Frame
+  {
+    Image image;
+    int head = 0;
+  };
+
+  //==============================================================================
+  /**
+   * @brief Creates a cleared single channel image.
+   *
+   * @param _width The image width.
+   * @param _height The image height.
+   */
+  [[nodiscard]] static inline Image makeImage(const int _width,
+                                              const int _height)
+  {
+#if !OS_IS_WINDOWS
+    return Image(PixelFormat::SingleChannel, _width, _height, true);
+#else
+    return Image(PixelFormat::SingleChannel,
+                 _width,
+                 _height,
+                 true,
+                 juce::SoftwareImageType{});
+#endif
+  }
+
+  //==============================================================================
+  /**
+   * @brief Gets the ring that only the worker touches.
+   */
+  [[nodiscard]] inline Frame& getBack() noexcept { return frames[1 - front]; }
+
+  //==============================================================================
+  /**
+   * @brief Swaps the back ring to the front.
    *
    * @details
-   * Periodically updates the oscilloscope image by rendering the latest audio
-   * samples. Uses a back buffer to avoid GUI contention.
-   * The wait interval is set high to minimize CPU usage; rendering is not
-   * continuous but event-driven.
+   * Only the worker writes front, so it reads it without the lock.
    */
-  inline void run() override
+  inline void publish() noexcept
   {
-    while (!threadShouldExit()) {
-      wait(10000);
+    const juce::SpinLock::ScopedLockType lock(frameLock);
+    front = 1 - front;
+  }
 
-      if (resizePending.exchange(false, std::memory_order_acq_rel)) {
-        resizeImage(renderWidth.load(std::memory_order_relaxed),
-                    renderHeight.load(std::memory_order_relaxed));
-      }
+  //==============================================================================
+  /**
+   * @brief Copies the whole front ring into the back ring.
+   *
+   * @details
+   * Used after the history was redrawn, or when the rings differ in size.
+   * The front ring is only read, which the GUI may do at the same time.
+   */
+  inline void syncBack()
+  {
+    const Frame& published = frames[front];
+    Frame& back = getBack();
+    const int width = published.image.getWidth();
+    const int height = published.image.getHeight();
 
-      render();
-    }
+    if (back.image.getWidth() != width || back.image.getHeight() != height)
+      back.image = makeImage(width, height);
+
+    copyColumns(published.image, 0, back.image, 0, width);
+    back.head = published.head;
   }
 
   //==============================================================================
   /**
-   * @brief Resizes the internal image buffer and draws the midline.
+   * @brief Resizes the back ring and the strip, and draws the midline.
    *
    * @param _width The new image width.
    * @param _height The new image height.
    *
    * @details
-   * The image is resized and a horizontal midline is drawn for reference.
+   * The ring is exactly as wide as the display. The strip is allocated at
+   * full width, so no frame ever needs a bigger one. The front ring keeps
+   * its old size until the history is drawn and swapped in.
    */
   inline void resizeImage(const int _width, const int _height)
   {
@@ -257,30 +378,20 @@ protected:
       return;
     }
 
-    for (auto& image : images) {
-#if !OS_IS_WINDOWS
-      image = Image(PixelFormat::ARGB, _width + 10, _height, true);
-#else
-      image = Image(PixelFormat::ARGB,
-                    _width + 10,
-                    _height,
-                    true,
-                    juce::SoftwareImageType{});
-#endif
-    }
+    Frame& back = getBack();
+    back.image = makeImage(_width, _height);
+    back.head = 0;
+    strip = makeImage(_width, _height);
 
-    frontBufferIndex.store(0, std::memory_order_release);
     subPixelOffset = 0.0f;
 
-    for (auto& image : images) {
-      juce::Graphics imageGraphics(image);
-      imageGraphics.setColour(juce::Colours::white);
-      imageGraphics.drawLine(0,
-                             static_cast<float>(_height) / 2.0f,
-                             static_cast<float>(_width + 10),
-                             static_cast<float>(_height) / 2.0f,
-                             3.0f);
-    }
+    juce::Graphics imageGraphics(back.image);
+    imageGraphics.setColour(juce::Colours::white);
+    imageGraphics.drawLine(0,
+                           static_cast<float>(_height) / 2.0f,
+                           static_cast<float>(_width),
+                           static_cast<float>(_height) / 2.0f,
+                           3.0f);
   }
 
   //==============================================================================
@@ -288,16 +399,21 @@ protected:
    * @brief Renders the oscilloscope waveform into the image.
    *
    * @details
-   * Reads samples from the ring buffer, updates the image by moving the
-   * existing content, clears the new region, and draws the waveform path.
-   * Uses explicit type conversions for safety and clarity.
+   * Reads samples from the ring buffer and draws them into the strip. The
+   * strip starts a few columns before the new region, with those columns
+   * copied from the ring, so the stroke joins the previous frame seamlessly.
+   * The strip is then copied into the back ring, which is swapped to the
+   * front, and then into the new back ring. Memory traffic scales with the
+   * new columns instead of the whole image.
    */
   inline void render()
   {
     TRACER("Oscilloscope::render");
 
-    const int width = renderWidth.load(std::memory_order_relaxed);
-    const int height = renderHeight.load(std::memory_order_relaxed);
+    // The ring itself is the authority, a resize may still be pending
+    Frame& back = getBack();
+    const int width = back.image.getWidth();
+    const int height = back.image.getHeight();
 
     if (width <= 0 || height <= 0)
       return;
@@ -310,15 +426,14 @@ protected:
     if (samplesPerPixel <= 0.0f)
       return;
 
-    const int bufferSize = ringBuffer.getNumSamples();
-    const int readPosition = ringBuffer.getReadPosition(channel);
-    const int samplesToRead = bufferSize - readPosition;
+    const auto readRange = ringBuffer.getReadRange(reader);
+    const int samplesToRead = readRange.size;
 
     const int maxSamplesToDraw =
       (int)std::floor(samplesPerPixel * (float)width);
 
     const int samplesToDraw = jmin(samplesToRead, maxSamplesToDraw);
-    const int firstSamplesToDraw = readPosition;
+    const int firstSamplesToDraw = readRange.start;
 
     const float exactPixelsToDraw = (float)samplesToDraw / samplesPerPixel;
 
@@ -328,35 +443,33 @@ protected:
     if (pixelToDraw <= 0)
       return;
 
-    ringBuffer.incrementReadPosition(channel, samplesToDraw);
-
-    const int currentFront = frontBufferIndex.load(std::memory_order_acquire);
-    const int backIndex = currentFront == 0 ? 1 : 0;
+    ringBuffer.incrementReadPosition(reader, samplesToDraw);
 
-    auto& backImage = images[(size_t)backIndex];
-
-    backImage = images[(size_t)currentFront].createCopy();
-
-    // Left scrolling
+    const float strokeWidth = thickness.load(std::memory_order_relaxed) * size;
     const int shift = jmin(pixelToDraw, width);
-    if (shift > 0) {
-      backImage.moveImageSection(0, 0, shift, 0, width - shift, height);
-      backImage.clear(juce::Rectangle<int>(width - shift, 0, shift, height),
-                      juce::Colours::transparentBlack);
-    }
+    const int margin = jmin((int)std::ceil(strokeWidth) + 1, width - shift);
+    const int head = back.head;
+
+    // The newest columns already in the ring end right before the old head
+    const int marginColumn = (head + width - margin) % width;
+    copyFromRing(back.image, marginColumn, margin, width);
+    strip.clear(juce::Rectangle<int>(margin, 0, shift, height),
+                juce::Colours::transparentBlack);
 
     // Render new audio data
-    juce::Graphics g(backImage);
+    juce::Graphics g(strip);
+    g.reduceClipRegion(0, 0, margin + shift, height);
 
     const typename Renderer::RenderContext context{
       firstSamplesToDraw,
       samplesToDraw,
-      (float)(width - shift) + subPixelOffset,
+      (float)margin + subPixelOffset,
       1.0f / samplesPerPixel,
       halfHeight,
       amplitude.load(std::memory_order_relaxed),
       thickness.load(std::memory_order_relaxed),
-      size
+      size,
+      &strip
     };
 
     subPixelOffset = totalShift - (float)pixelToDraw;
@@ -366,12 +479,157 @@ protected:
       currentRenderer->draw(g, ringBuffer, channel, context);
     }
 
-    frontBufferIndex.store(backIndex, std::memory_order_release);
+    copyToRing(back.image, marginColumn, margin + shift, width);
+    back.head = (head + shift) % width;
+    publish();
+
+    // The new back ring is a frame behind, unless it still has an old size
+    Frame& next = getBack();
+    if (next.image.getBounds() != back.image.getBounds()) {
+      syncBack();
+      return;
+    }
+
+    copyToRing(next.image, marginColumn, margin + shift, width);
+    next.head = back.head;
+  }
+
+  //==============================================================================
+  /**
+   * @brief Copies columns from a ring to the start of the strip.
+   *
+   * @param _ring The ring to copy from.
+   * @param _ringColumn The first ring column to copy.
+   * @param _numColumns The number of columns to copy.
+   * @param _width The ring width.
+   */
+  inline void copyFromRing(const Image& _ring,
+                           const int _ringColumn,
+                           const int _numColumns,
+                           const int _width) noexcept
+  {
+    const int first = jmin(_numColumns, _width - _ringColumn);
+    copyColumns(_ring, _ringColumn, strip, 0, first);
+    copyColumns(_ring, 0, strip, first, _numColumns - first);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Copies columns from the start of the strip into a ring.
+   *
+   * @param _ring The ring to write.
+   * @param _ringColumn The first ring column to write.
+   * @param _numColumns The number of columns to copy.
+   * @param _width The ring width.
+   */
+  inline void copyToRing(Image& _ring,
+                         const int _ringColumn,
+                         const int _numColumns,
+                         const int _width) noexcept
+  {
+    const int first = jmin(_numColumns, _width - _ringColumn);
+    copyColumns(strip, 0, _ring, _ringColumn, first);
+    copyColumns(strip, first, _ring, 0, _numColumns - first);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Copies a block of whole-height columns between two images.
+   *
+   * @details
+   * Copies the raw pixels row by row. Drawing the image instead would blend
+   * it over the destination and cost far more.
+   */
+  static inline void copyColumns(const Image& _source,
+                                 const int _sourceX,
+                                 Image& _destination,
+                                 const int _destinationX,
+                                 const int _numColumns) noexcept
+  {
+    if (_numColumns <= 0)
+      return;
+
+    const int height = _destination.getHeight();
+    const Image::BitmapData source(
+      _source, _sourceX, 0, _numColumns, height, Image::BitmapData::readOnly);
+    Image::BitmapData destination(_destination,
+                                  _destinationX,
+                                  0,
+                                  _numColumns,
+                                  height,
+                                  Image::BitmapData::writeOnly);
+    const size_t rowBytes = (size_t)(_numColumns * source.pixelStride);
+
+    for (int y = 0; y < height; ++y)
+      std::memcpy(destination.getLinePointer(y),
+                  source.getLinePointer(y),
+                  rowBytes);
+  }
+
+  //==============================================================================
+  /**
+   * @brief Draws the whole image again from the history in the ring buffer.
+   *
+   * @details
+   * Used after a zoom change or a resize. At high zoom levels the renderer
+   * reads the min/max pyramid, so this costs about as much as a normal frame.
+   * The history is drawn into the back ring with the write head reset, so
+   * it is in display order, and only then swapped to the front. The GUI keeps
+   * painting the previous frame meanwhile.
+   */
+  inline void renderHistory()
+  {
+    TRACER("Oscilloscope::renderHistory");
+
+    Frame& back = getBack();
+    Image& image = back.image;
+    const int width = image.getWidth();
+    const int height = image.getHeight();
+    const float samplesPerPixel =
+      rawSamplesPerPixel.load(std::memory_order_relaxed) * size;
+
+    if (width <= 0 || height <= 0 || samplesPerPixel <= 0.0f)
+      return;
+
+    const int maxSamplesToDraw =
+      (int)std::floor(samplesPerPixel * (float)width);
+    const auto history = ringBuffer.getHistoryRange(reader, maxSamplesToDraw);
+
+    back.head = 0;
+    image.clear(image.getBounds(), juce::Colours::transparentBlack);
+
+    subPixelOffset = 0.0f;
+
+    if (history.size > 0) {
+      juce::Graphics g(image);
+      const float pixelsToDraw = (float)history.size / samplesPerPixel;
+
+      const typename Renderer::RenderContext context{
+        history.start,
+        history.size,
+        (float)width - pixelsToDraw,
+        1.0f / samplesPerPixel,
+        height / 2,
+        amplitude.load(std::memory_order_relaxed),
+        thickness.load(std::memory_order_relaxed),
+        size,
+        &image
+      };
+
+      if (auto currentRenderer =
+            std::atomic_load_explicit(&renderer, std::memory_order_acquire)) {
+        currentRenderer->draw(g, ringBuffer, channel, context);
+      }
+    }
+
+    publish();
+    syncBack();
   }
 
   //==============================================================================
   // Members initialized in the initializer list
   RingBuffer& ringBuffer;
+  const int reader;
   const int32_t channel;
 
   //==============================================================================
@@ -379,20 +637,16 @@ protected:
 
   juce::Rectangle<int> bounds = juce::Rectangle<int>(0, 0, 1, 1);
 
-#if !OS_IS_WINDOWS
-  std::array<Image, 2> images = { Image(PixelFormat::ARGB, 1, 1, true),
-                                  Image(PixelFormat::ARGB, 1, 1, true) };
-#else
-  std::array<Image, 2> images = {
-    Image(PixelFormat::ARGB, 1, 1, true, juce::SoftwareImageType{}),
-    Image(PixelFormat::ARGB, 1, 1, true, juce::SoftwareImageType{})
-  };
-#endif
+  // The front ring is painted, the back ring is written by the worker
+  Frame frames[2] = { { makeImage(1, 1) }, { makeImage(1, 1) } };
+  int front = 0;
+  mutable juce::SpinLock frameLock;
+  Image strip = makeImage(1, 1);
 
-  std::atomic<int> frontBufferIndex{ 0 };
   std::atomic<int> renderWidth{ 1 };
   std::atomic<int> renderHeight{ 1 };
   std::atomic<bool> resizePending{ true };
+  std::atomic<bool> historyPending{ false };
 
   std::shared_ptr<Renderer> renderer;
   float subPixelOffset = 0.0f;
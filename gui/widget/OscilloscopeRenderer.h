@@ -105,6 +105,9 @@ public:
 
     /** Global size scaling factor. */
     float sizeFactor;
+
+    /** The image the graphics context draws into, for direct pixel access. */
+    juce::Image* image;
   };
   //============================================================================
   /**
@@ -132,8 +135,9 @@ public:
    * @details
    * Implementations should read samples directly from the ring buffer using
    * the indices provided in the context. The Graphics context is already
-   * attached to the oscilloscope image, and the image has already been
-   * scrolled and cleared by the Oscilloscope class.
+   * attached to the image in the context, and the columns of the new samples
+   * have already been cleared by the Oscilloscope class. Renderers may also
+   * write to that image directly instead of using the Graphics context.
    */
   virtual void draw(juce::Graphics& _graphics,
                     RingBuffer& _ringBuffer,
@@ -62,6 +62,8 @@ class PathStrokeRenderer : public OscilloscopeRenderer<SampleType>
 {
   //============================================================================
 public:
+  PathStrokeRenderer() = default;
+
   using RingBuffer = typename OscilloscopeRenderer<SampleType>::RingBuffer;
   using RenderContext =
     typename OscilloscopeRenderer<SampleType>::RenderContext;
@@ -0,0 +1,172 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Shared background thread that renders all oscilloscope displays when they
+ * request a frame, so the number of render threads doesn't grow with the
+ * number of plugin instances.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+
+namespace dmt {
+namespace gui {
+namespace widget {
+
+//==============================================================================
+/**
+ * @brief One render thread shared by every oscilloscope in the process.
+ *
+ * @details
+ * Jobs register themselves and then mark that they want a new frame, which
+ * wakes the worker. It sleeps until then, so nothing runs while no display
+ * is showing. A job is a whole display, which renders all of its channels,
+ * and the ring buffer they read, in one go. The thread count doesn't depend
+ * on the number of displays or plugin instances.
+ *
+ * Use it through juce::SharedResourcePointer, so the thread only exists
+ * while at least one display does.
+ *
+ * The worker takes the marked jobs out under jobsLock and renders them after
+ * releasing it, so add() and remove() never wait for a whole pass. Each job
+ * is rendered under renderLock, which remove() takes after dropping the job
+ * from the pass, so once it returns the job is never touched again.
+ */
+class RenderWorker : private juce::Thread
+{
+public:
+  //============================================================================
+  /**
+   * @brief Something the worker renders once per requested frame.
+   */
+  class Job
+  {
+  public:
+    virtual ~Job() = default;
+
+    /** @brief Renders one frame. Called on the worker thread. */
+    virtual void renderFrame() = 0;
+
+  private:
+    friend class RenderWorker;
+    std::atomic<bool> pending{ false };
+  };
+
+  //============================================================================
+  RenderWorker()
+    : Thread("OscilloscopeRenderWorker")
+  {
+    startThread();
+  }
+
+  ~RenderWorker() override { stopThread(1000); }
+
+  //============================================================================
+  /**
+   * @brief Registers a job. Its frames are only rendered once requested.
+   */
+  inline void add(Job& _job)
+  {
+    const juce::ScopedLock lock(jobsLock);
+    jobs.push_back(&_job);
+  }
+
+  //============================================================================
+  /**
+   * @brief Unregisters a job, waiting for a frame in progress to finish.
+   */
+  inline void remove(Job& _job)
+  {
+    {
+      const juce::ScopedLock lock(jobsLock);
+      jobs.erase(std::remove(jobs.begin(), jobs.end(), &_job), jobs.end());
+      std::replace(pass.begin(), pass.end(), &_job, static_cast<Job*>(nullptr));
+    }
+
+    // Blocks for at most the one job being rendered
+    const juce::ScopedLock lock(renderLock);
+  }
+
+  //============================================================================
+  /**
+   * @brief Marks a job to be rendered and wakes the worker.
+   *
+   * @details
+   * Only the request that marks the job wakes the worker, several requests
+   * before it gets to the job render a single frame.
+   */
+  inline void request(Job& _job) noexcept
+  {
+    if (!_job.pending.exchange(true, std::memory_order_acq_rel))
+      notify();
+  }
+
+private:
+  //============================================================================
+  inline void run() override
+  {
+    while (!threadShouldExit()) {
+      wait(-1);
+
+      {
+        const juce::ScopedLock lock(jobsLock);
+        pass.clear();
+        for (auto* job : jobs)
+          if (job->pending.exchange(false, std::memory_order_acq_rel))
+            pass.push_back(job);
+      }
+
+      for (size_t index = 0; index < pass.size(); ++index) {
+        const juce::ScopedLock lock(renderLock);
+        Job* job = nullptr;
+        {
+          // remove() may have dropped the job since the pass was taken
+          const juce::ScopedLock jobLock(jobsLock);
+          job = pass[index];
+        }
+        if (job != nullptr)
+          job->renderFrame();
+      }
+    }
+  }
+
+  //============================================================================
+  juce::CriticalSection jobsLock;
+  juce::CriticalSection renderLock;
+  std::vector<Job*> jobs;
+  std::vector<Job*> pass;
+
+  //============================================================================
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderWorker)
+};
+
+} // namespace widget
+} // namespace gui
+} // namespace dmt
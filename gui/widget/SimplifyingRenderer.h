@@ -0,0 +1,219 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Path stroke oscilloscope renderer that simplifies each frame's segment
+ * with the Ramer-Douglas-Peucker algorithm before stroking it, so zoomed in
+ * views of slow waveforms stroke far fewer vertices.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+//==============================================================================
+
+#include "gui/widget/OscilloscopeRenderer.h"
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+
+namespace dmt {
+namespace gui {
+namespace widget {
+
+//==============================================================================
+/**
+ * @brief Path stroke renderer with Ramer-Douglas-Peucker simplification.
+ *
+ * @tparam SampleType The sample type (e.g., float, double) used for audio data.
+ *
+ * @details
+ * Draws the same path as PathStrokeRenderer, one vertex per sample, but drops
+ * every vertex that is closer than a quarter pixel to the line between the
+ * vertices kept around it. Zoomed in on low-frequency material most samples
+ * lie on such lines, so the stroked path shrinks to a handful of vertices.
+ * The algorithm is the one prototyped in test/rdp_test.py.
+ *
+ * The recursion of the textbook version is replaced by an explicit stack, and
+ * all buffers, including the path, are kept between frames. Once they have
+ * grown to the largest frame, no frame allocates.
+ *
+ * The first and last vertex of every frame are always kept, so the waveform
+ * stays continuous across frames like with the other renderers.
+ */
+template<typename SampleType>
+class SimplifyingRenderer : public OscilloscopeRenderer<SampleType>
+{
+  //============================================================================
+public:
+  SimplifyingRenderer() = default;
+
+  using RingBuffer = typename OscilloscopeRenderer<SampleType>::RingBuffer;
+  using RenderContext =
+    typename OscilloscopeRenderer<SampleType>::RenderContext;
+
+  //============================================================================
+  /**
+   * @brief Draws a simplified waveform segment using path stroking.
+   *
+   * @param _graphics The JUCE Graphics context targeting the oscilloscope
+   *                  image.
+   * @param _ringBuffer Reference to the ring buffer containing audio samples.
+   * @param _channel The audio channel index to read from.
+   * @param _context Pre-computed rendering parameters for this frame.
+   */
+  inline void draw(juce::Graphics& _graphics,
+                   RingBuffer& _ringBuffer,
+                   int _channel,
+                   const RenderContext& _context) override
+  {
+    this->currentX = _context.drawStartX;
+    collectPoints(_ringBuffer, _channel, _context);
+    simplify();
+
+    path.clear();
+    path.startNewSubPath(points.front());
+    for (size_t i = 1; i < points.size(); ++i)
+      if (keep[i])
+        path.lineTo(points[i]);
+
+    this->strokePath(_graphics, path, _context);
+  }
+
+  //============================================================================
+private:
+  // Vertices closer than this many pixels to the simplified line are dropped
+  static constexpr float tolerance = 0.25f;
+
+  // Longest run of vertices simplified as one line
+  static constexpr size_t maxRun = 512;
+
+  //============================================================================
+  /**
+   * @brief Reads the vertices of the frame, starting at the previous one.
+   *
+   * @details
+   * Advances currentX and currentSample the same way PathStrokeRenderer does.
+   */
+  inline void collectPoints(RingBuffer& _ringBuffer,
+                            int _channel,
+                            const RenderContext& _context)
+  {
+    const auto sampleCount = static_cast<size_t>(_context.sampleCount);
+    points.resize(sampleCount + 1);
+    keep.resize(sampleCount + 1);
+
+    points[0] = { this->currentX,
+                  this->sampleToY(this->currentSample,
+                                  _context.halfHeight,
+                                  _context.amplitude) };
+
+    for (size_t i = 0; i < sampleCount; ++i) {
+      const int sampleIndex = _context.firstSampleIndex + static_cast<int>(i);
+      this->currentSample = _ringBuffer.getSample(_channel, sampleIndex);
+      this->currentX += _context.pixelsPerSample;
+      points[i + 1] = { this->currentX,
+                        this->sampleToY(this->currentSample,
+                                        _context.halfHeight,
+                                        _context.amplitude) };
+    }
+  }
+
+  //============================================================================
+  /**
+   * @brief Marks the vertices the simplified path keeps.
+   *
+   * @details
+   * Each range on the stack is a line between two kept vertices. The vertex
+   * farthest from that line is kept if it is beyond the tolerance, and the
+   * two halves are pushed. Distances are compared squared and scaled by the
+   * squared line length, so no square root is needed.
+   *
+   * Noise at high zoom levels keeps almost every vertex, where RDP tends
+   * towards quadratic time. The frame is therefore simplified in runs of at
+   * most maxRun vertices, which bounds a full redraw without changing the
+   * result of the short segments of normal frames.
+   */
+  inline void simplify()
+  {
+    const size_t last = points.size() - 1;
+    std::fill(keep.begin(), keep.end(), false);
+    keep[last] = true;
+
+    stack.clear();
+    for (size_t first = 0; first < last; first += maxRun) {
+      const size_t end = std::min(first + maxRun, last);
+      keep[first] = true;
+      if (end - first > 1)
+        stack.push_back({ first, end });
+    }
+
+    while (!stack.empty()) {
+      const auto [first, end] = stack.back();
+      stack.pop_back();
+
+      const auto start = points[first];
+      const auto direction = points[end] - start;
+      const float lengthSquared = direction.getDistanceSquaredFromOrigin();
+
+      float farthestCross = 0.0f;
+      size_t farthest = first;
+      for (size_t i = first + 1; i < end; ++i) {
+        const auto offset = points[i] - start;
+        const float cross = direction.getX() * offset.getY() -
+                            direction.getY() * offset.getX();
+        if (cross * cross > farthestCross) {
+          farthestCross = cross * cross;
+          farthest = i;
+        }
+      }
+
+      if (farthestCross <= tolerance * tolerance * lengthSquared)
+        continue;
+
+      keep[farthest] = true;
+      if (farthest - first > 1)
+        stack.push_back({ first, farthest });
+      if (end - farthest > 1)
+        stack.push_back({ farthest, end });
+    }
+  }
+
+  //============================================================================
+  struct Range
+  {
+    size_t first;
+    size_t end;
+  };
+
+  std::vector<juce::Point<float>> points;
+  std::vector<bool> keep;
+  std::vector<Range> stack;
+  juce::Path path;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimplifyingRenderer)
+};
+
+} // namespace widget
+} // namespace gui
+} // namespace dmt
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ParameterRegistry.h"
 #include <JuceHeader.h>
 
 //==============================================================================
@@ -69,5 +70,30 @@ envelopeParameterGroup(juce::String parentUid,
                                      defaultValues[5])         // defaultValue
   );
 }
+//==============================================================================
+struct EnvelopeParameterHandles
+{
+  ParameterHandle<bool> enabled;
+  ParameterHandle<float> attack;
+  ParameterHandle<float> hold;
+  ParameterHandle<float> decay;
+  ParameterHandle<float> depth;
+  ParameterHandle<float> attackBend;
+  ParameterHandle<float> decayBend;
+
+  inline void resolve(const ParameterRegistry& _registry,
+                      const juce::String& _parentUid,
+                      const juce::String& _suffix) noexcept
+  {
+    const juce::String uid = _parentUid + _suffix + "Env";
+    enabled = _registry.get<bool>(uid + "Enabled");
+    attack = _registry.get<float>(uid + "Attack");
+    hold = _registry.get<float>(uid + "Hold");
+    decay = _registry.get<float>(uid + "Decay");
+    depth = _registry.get<float>(uid + "Depth");
+    attackBend = _registry.get<float>(uid + "AttackBend");
+    decayBend = _registry.get<float>(uid + "DecayBend");
+  }
+};
 } // namespace model
 } // namespace dmt
\ No newline at end of file
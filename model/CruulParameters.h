@@ -2,6 +2,7 @@
 
 //==============================================================================
 
+#include "ParameterRegistry.h"
 #include <JuceHeader.h>
 #include <dmt/utility/Unit.h>
 
@@ -115,5 +116,42 @@ cruulParameterGroup(juce::String parentUid, int versionHint)
                         0.25f),   // skewFactor
       20000.0f));
 }
+
+//==============================================================================
+
+struct CruulParameterHandles
+{
+  ParameterHandle<float> preGain;
+  ParameterHandle<float> spread;
+  ParameterHandle<float> range;
+  ParameterHandle<float> mix;
+  ParameterHandle<float> distortion;
+  ParameterHandle<float> drive;
+  ParameterHandle<int> driveType;
+  ParameterHandle<float> driveBias;
+  ParameterHandle<float> feedback;
+  ParameterHandle<int> feedbackFilterSlope;
+  ParameterHandle<float> feedbackFilterCutoff;
+
+  inline void resolve(const ParameterRegistry& _registry,
+                      const juce::String& _parentUid = {}) noexcept
+  {
+    const juce::String uid = _parentUid + "Cruul";
+    preGain = _registry.get<float>(uid + "PreGain");
+    spread = _registry.get<float>(uid + "Spread");
+    range = _registry.get<float>(uid + "Range");
+    mix = _registry.get<float>(uid + "Mix");
+    distortion = _registry.get<float>(uid + "Distortion");
+    drive = _registry.get<float>(uid + "Drive");
+    driveType = _registry.get<int>(uid + "DriveType");
+    driveBias = _registry.get<float>(uid + "DriveBias");
+    feedback = _registry.get<float>(uid + "Feedback");
+    feedbackFilterSlope = _registry.get<int>(uid + "FeedbackFilterSlope");
+    feedbackFilterCutoff = _registry.get<float>(uid + "FeedbackFilterCutoff");
+  }
+};
+
+//==============================================================================
+
 } // namespace model
 } // namespace dmt
\ No newline at end of file
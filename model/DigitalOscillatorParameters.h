@@ -1,6 +1,7 @@
 #pragma once
 
-#include "../dsp/synth/DigitalOscillator.h"
+#include "../dsp/synth/DigitalWaveform.h"
+#include "ParameterRegistry.h"
 #include <JuceHeader.h>
 
 //==============================================================================
@@ -79,5 +80,33 @@ digitalOscillatorParameterGroup(juce::String parentUid)
                                      3.0f)                    // defaultValue
   );
 }
+//==============================================================================
+struct DigitalOscillatorParameterHandles
+{
+  using DigitalWaveform = dmt::dsp::synth::DigitalWaveform;
+
+  ParameterHandle<DigitalWaveform::Type> type;
+  ParameterHandle<float> warp;
+  ParameterHandle<float> bend;
+  ParameterHandle<float> pwm;
+  ParameterHandle<float> sync;
+  ParameterHandle<float> bias;
+  ParameterHandle<float> clip;
+  ParameterHandle<float> drive;
+
+  inline void resolve(const ParameterRegistry& _registry,
+                      const juce::String& _parentUid) noexcept
+  {
+    const juce::String uid = _parentUid + "DigitalOscillator";
+    type = _registry.get<DigitalWaveform::Type>(uid + "Type");
+    warp = _registry.get<float>(uid + "Warp");
+    bend = _registry.get<float>(uid + "Bend");
+    pwm = _registry.get<float>(uid + "Pwm");
+    sync = _registry.get<float>(uid + "Sync");
+    bias = _registry.get<float>(uid + "Bias");
+    clip = _registry.get<float>(uid + "Clip");
+    drive = _registry.get<float>(uid + "Drive");
+  }
+};
 } // namespace model
 } // namespace dmt
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 //==============================================================================
+#include "ParameterRegistry.h"
 #include <JuceHeader.h>
 //==============================================================================
 namespace dmt {
@@ -65,5 +66,25 @@ disfluxParameterGroup(juce::String parentUid, int versionHint)
       1.0f,                    // defaultValue
       juce::String()));
 }
+//==============================================================================
+struct DisfluxParameterHandles
+{
+  ParameterHandle<int> amount;
+  ParameterHandle<int> spread;
+  ParameterHandle<float> frequency;
+  ParameterHandle<float> pinch;
+  ParameterHandle<float> mix;
+
+  inline void resolve(const ParameterRegistry& _registry,
+                      const juce::String& _parentUid = {}) noexcept
+  {
+    const juce::String uid = _parentUid + "Disflux";
+    amount = _registry.get<int>(uid + "Amount");
+    spread = _registry.get<int>(uid + "Spread");
+    frequency = _registry.get<float>(uid + "Frequency");
+    pinch = _registry.get<float>(uid + "Pinch");
+    mix = _registry.get<float>(uid + "Mix");
+  }
+};
 } // namespace model
 } // namespace dmt
\ No newline at end of file
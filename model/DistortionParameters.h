@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ParameterRegistry.h"
 #include <JuceHeader.h>
 
 //==============================================================================
@@ -63,5 +64,25 @@ distortionParameterGroup(juce::String parentUid)
                                      16.f)                   // defaultValue
   );
 }
+//==============================================================================
+struct DistortionParameterHandles
+{
+  ParameterHandle<int> type;
+  ParameterHandle<float> preGain;
+  ParameterHandle<float> drive;
+  ParameterHandle<float> symmetry;
+  ParameterHandle<float> crush;
+
+  inline void resolve(const ParameterRegistry& _registry,
+                      const juce::String& _parentUid) noexcept
+  {
+    const juce::String uid = _parentUid + "Distortion";
+    type = _registry.get<int>(uid + "Type");
+    preGain = _registry.get<float>(uid + "PreGain");
+    drive = _registry.get<float>(uid + "Drive");
+    symmetry = _registry.get<float>(uid + "Symmetry");
+    crush = _registry.get<float>(uid + "Crush");
+  }
+};
 } // namespace model
-} // namespace dmt
\ No newline at end of file
+} // namespace dmt
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+//==============================================================================
+#include "ParameterRegistry.h"
+#include <JuceHeader.h>
+//==============================================================================
+namespace dmt {
+namespace model {
+//==============================================================================
+// The Lowpass parameters are declared by the plugins themselves, so there is
+// no layout here. The IDs, including "LowPassFrequency", are the ones the
+// processor always looked up.
+struct LowpassParameterHandles
+{
+  ParameterHandle<int> stages;
+  ParameterHandle<float> frequency;
+  ParameterHandle<float> mix;
+
+  inline void resolve(const ParameterRegistry& _registry) noexcept
+  {
+    stages = _registry.get<int>("LowpassStages");
+    frequency = _registry.get<float>("LowPassFrequency");
+    mix = _registry.get<float>("LowpassMix");
+  }
+};
+} // namespace model
+} // namespace dmt
@@ -2,6 +2,10 @@
 #include "CruulParameters.h"
 #include "DisfluxParameters.h"
 #include "GlobalParameters.h"
+#include "LowpassParameters.h"
 #include "NeutrinoParameters.h"
 #include "OscilloscopeParameters.h"
+#include "ParameterRegistry.h"
+#include "SynthVoiceParameters.h"
+#include "VoicingParameters.h"
 
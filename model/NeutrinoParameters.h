@@ -2,6 +2,7 @@
 //==============================================================================
 #include "AhdEnvelopeParameters.h"
 #include "DigitalOscillatorParameters.h"
+#include "ParameterRegistry.h"
 #include <JuceHeader.h>
 //==============================================================================
 namespace dmt {
@@ -34,5 +35,23 @@ neutrinoParameterGroup(juce::String parentUid, [[maybe_unused]] int versionHint)
     std::make_unique<ParameterGroup>(envelopeParameterGroup(
       uid, "Pitch2", { 0.0f, 0.0f, 0.02f, 0.033f, 0.0f, 0.0f })));
 }
+//==============================================================================
+struct NeutrinoParameterHandles
+{
+  DigitalOscillatorParameterHandles oscillator;
+  EnvelopeParameterHandles gainEnvelope;
+  EnvelopeParameterHandles pitchEnvelope1;
+  EnvelopeParameterHandles pitchEnvelope2;
+
+  inline void resolve(const ParameterRegistry& _registry,
+                      const juce::String& _parentUid = {}) noexcept
+  {
+    const juce::String uid = _parentUid + "Neutrino";
+    oscillator.resolve(_registry, uid);
+    gainEnvelope.resolve(_registry, uid, "Gain");
+    pitchEnvelope1.resolve(_registry, uid, "Pitch1");
+    pitchEnvelope2.resolve(_registry, uid, "Pitch2");
+  }
+};
 } // namespace model
 } // namespace dmt
\ No newline at end of file
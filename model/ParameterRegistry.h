@@ -0,0 +1,83 @@
+#pragma once
+//==============================================================================
+#include <JuceHeader.h>
+#include <type_traits>
+//==============================================================================
+namespace dmt {
+namespace model {
+//==============================================================================
+/**
+ * @brief Typed handle to the raw value of a parameter.
+ *
+ * @details
+ * Wraps the std::atomic<float> that juce::AudioProcessorValueTreeState keeps
+ * for each parameter. Loading through the handle does no lookup and no
+ * allocation, so it is safe on the audio thread. Bools compare against 0.5,
+ * while ints and enums truncate the raw value like a static_cast would.
+ */
+template<typename ValueType>
+class ParameterHandle
+{
+public:
+  ParameterHandle() noexcept = default;
+
+  explicit ParameterHandle(std::atomic<float>* _value) noexcept
+    : value(_value)
+  {
+  }
+
+  [[nodiscard]] forcedinline ValueType load() const noexcept
+  {
+    jassert(value != nullptr);
+    const float raw = value->load(std::memory_order_relaxed);
+    if constexpr (std::is_same_v<ValueType, bool>) {
+      return raw > 0.5f;
+    } else if constexpr (std::is_enum_v<ValueType>) {
+      return static_cast<ValueType>(static_cast<int>(raw));
+    } else {
+      return static_cast<ValueType>(raw);
+    }
+  }
+
+  [[nodiscard]] inline bool isValid() const noexcept
+  {
+    return value != nullptr;
+  }
+
+private:
+  std::atomic<float>* value = nullptr;
+};
+
+//==============================================================================
+/**
+ * @brief Hands out parameter handles by ID.
+ *
+ * @details
+ * Only meant to be used while preparing, as every call looks the ID up in the
+ * value tree. The handle groups next to the parameter layouts build their IDs
+ * the same way the layouts do, so both stay in sync.
+ */
+class ParameterRegistry
+{
+public:
+  explicit ParameterRegistry(
+    const juce::AudioProcessorValueTreeState& _apvts) noexcept
+    : apvts(_apvts)
+  {
+  }
+
+  template<typename ValueType>
+  [[nodiscard]] inline ParameterHandle<ValueType> get(
+    const juce::String& _parameterId) const noexcept
+  {
+    auto* value = apvts.getRawParameterValue(_parameterId);
+    // The parameter is missing from the layout the plugin was built with
+    jassert(value != nullptr);
+    return ParameterHandle<ValueType>(value);
+  }
+
+private:
+  const juce::AudioProcessorValueTreeState& apvts;
+};
+} // namespace model
+} // namespace dmt
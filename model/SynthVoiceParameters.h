@@ -0,0 +1,53 @@
+#pragma once
+//==============================================================================
+#include "DistortionParameters.h"
+#include "ParameterRegistry.h"
+#include "VoicingParameters.h"
+#include "WaveformParameters.h"
+#include <JuceHeader.h>
+//==============================================================================
+namespace dmt {
+namespace model {
+//==============================================================================
+// Everything the analog SynthVoice reads from one oscillator, e.g. "osc1".
+// The Waveform and Distortion IDs come from their layouts. The envelopes are
+// declared by the plugins themselves, like the Voicing parameters, and are
+// named after the envelope, e.g. "osc1GainEnvSkew".
+struct SynthVoiceParameterHandles
+{
+  VoicingParameterHandles voicing;
+  WaveformParameterHandles waveform;
+  DistortionParameterHandles distortion;
+
+  ParameterHandle<float> gainAttack;
+  ParameterHandle<float> gainHold;
+  ParameterHandle<float> gainDecay;
+  ParameterHandle<float> gainSkew;
+
+  ParameterHandle<float> pitchHold;
+  ParameterHandle<float> pitchDecay;
+  ParameterHandle<float> pitchSkew;
+  ParameterHandle<float> pitchDepth;
+
+  inline void resolve(const ParameterRegistry& _registry,
+                      const juce::String& _prefix = "osc1") noexcept
+  {
+    voicing.resolve(_registry, _prefix);
+    waveform.resolve(_registry, _prefix);
+    distortion.resolve(_registry, _prefix);
+
+    const juce::String gainUid = _prefix + "GainEnv";
+    gainAttack = _registry.get<float>(gainUid + "Attack");
+    gainHold = _registry.get<float>(gainUid + "Hold");
+    gainDecay = _registry.get<float>(gainUid + "Decay");
+    gainSkew = _registry.get<float>(gainUid + "Skew");
+
+    const juce::String pitchUid = _prefix + "PitchEnv";
+    pitchHold = _registry.get<float>(pitchUid + "Hold");
+    pitchDecay = _registry.get<float>(pitchUid + "Decay");
+    pitchSkew = _registry.get<float>(pitchUid + "Skew");
+    pitchDepth = _registry.get<float>(pitchUid + "Depth");
+  }
+};
+} // namespace model
+} // namespace dmt
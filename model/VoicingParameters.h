@@ -0,0 +1,42 @@
+#pragma once
+//==============================================================================
+#include "ParameterRegistry.h"
+#include <JuceHeader.h>
+//==============================================================================
+namespace dmt {
+namespace model {
+//==============================================================================
+// The Voicing parameters are declared by the plugins themselves, so there is
+// no layout here. The IDs are the ones the VoicingPanel attaches to, e.g.
+// "osc1VoiceDensity" for the prefix "osc1".
+struct VoicingParameterHandles
+{
+  ParameterHandle<int> density;
+  ParameterHandle<float> detune;
+  ParameterHandle<float> distribution;
+  ParameterHandle<float> width;
+  ParameterHandle<float> blend;
+  ParameterHandle<int> seed;
+  ParameterHandle<float> random;
+  ParameterHandle<float> phase;
+  ParameterHandle<int> octave;
+  ParameterHandle<int> semitone;
+
+  inline void resolve(const ParameterRegistry& _registry,
+                      const juce::String& _prefix = "osc1") noexcept
+  {
+    const juce::String uid = _prefix + "Voice";
+    density = _registry.get<int>(uid + "Density");
+    detune = _registry.get<float>(uid + "Detune");
+    distribution = _registry.get<float>(uid + "Distribution");
+    width = _registry.get<float>(uid + "Width");
+    blend = _registry.get<float>(uid + "Blend");
+    seed = _registry.get<int>(uid + "Seed");
+    random = _registry.get<float>(uid + "Random");
+    phase = _registry.get<float>(uid + "Phase");
+    octave = _registry.get<int>(uid + "Octave");
+    semitone = _registry.get<int>(uid + "Semitone");
+  }
+};
+} // namespace model
+} // namespace dmt
@@ -2,6 +2,7 @@
 
 #include <JuceHeader.h>
 #include "../dsp/synth/AnalogWaveform.h"
+#include "ParameterRegistry.h"
 
 //==============================================================================
 namespace dmt {
@@ -47,5 +48,25 @@ waveformParameterGroup(juce::String parentUid)
                                      .0f)                   // defaultValue)                   
   );
 }
+//==============================================================================
+struct WaveformParameterHandles
+{
+  using AnalogWaveform = dmt::dsp::synth::AnalogWaveform;
+
+  ParameterHandle<AnalogWaveform::Type> type;
+  ParameterHandle<float> bend;
+  ParameterHandle<float> pwm;
+  ParameterHandle<float> sync;
+
+  inline void resolve(const ParameterRegistry& _registry,
+                      const juce::String& _parentUid) noexcept
+  {
+    const juce::String uid = _parentUid + "Waveform";
+    type = _registry.get<AnalogWaveform::Type>(uid + "Type");
+    bend = _registry.get<float>(uid + "Bend");
+    pwm = _registry.get<float>(uid + "Pwm");
+    sync = _registry.get<float>(uid + "Sync");
+  }
+};
 } // namespace model
-} // namespace dmt
\ No newline at end of file
+} // namespace dmt
\ No newline at end of file
@@ -0,0 +1,130 @@
+//==============================================================================
+// Benchmark comparing the sample-major and stage-major processing orders of
+// the biquad cascade used by the DisfluxProcessor.
+//
+// Build it as a console app against juce_audio_basics and juce_dsp with the
+// repository root on the include path, for example:
+//   g++ -std=c++20 -O3 -I<repo> -I<juce-headers> disflux_order_benchmark.cpp
+// Any optimisation level below -O2 makes the numbers meaningless.
+//
+// Stage-major blocks are split every SMOOTHING_INTERVAL samples, the same way
+// DisfluxProcessor splits them while its parameters are smoothing.
+#include "dsp/filter/BiquadCascade.h"
+#include <JuceHeader.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+//==============================================================================
+constexpr size_t MAX_STAGES = 256;
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr int SMOOTHING_INTERVAL = 64;
+constexpr int SAMPLES_PER_RUN = 1 << 18;
+constexpr int REPETITIONS = 5;
+constexpr size_t AMOUNTS[] = { 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+constexpr int BLOCK_SIZES[] = { 32, 64, 128, 256, 512, 1024, 2048 };
+
+using Cascade = dmt::dsp::filter::BiquadCascade<2, MAX_STAGES>;
+using Clock = std::chrono::steady_clock;
+//==============================================================================
+static void setAllpassCoefficients(Cascade& cascade, size_t amount)
+{
+  for (size_t stage = 0; stage < amount; ++stage) {
+    const double position = amount == 1 ? 0.5 : double(stage) / (amount - 1);
+    const double frequency = 20.0 * std::pow(1000.0, position);
+    cascade.setCoefficients(
+      stage, juce::IIRCoefficients::makeAllPass(SAMPLE_RATE, frequency, 1.0));
+  }
+}
+//==============================================================================
+static void processSampleMajor(Cascade& cascade,
+                               float* const* channels,
+                               int numSamples,
+                               size_t amount)
+{
+  for (int sample = 0; sample < numSamples; ++sample) {
+    Cascade::Frame frame = { channels[0][sample], channels[1][sample] };
+    cascade.processFrame(frame, amount);
+    channels[0][sample] = frame[0];
+    channels[1][sample] = frame[1];
+  }
+}
+//==============================================================================
+static void processStageMajor(Cascade& cascade,
+                              float* const* channels,
+                              int numSamples,
+                              size_t amount)
+{
+  for (int start = 0; start < numSamples; start += SMOOTHING_INTERVAL) {
+    const int length = std::min(SMOOTHING_INTERVAL, numSamples - start);
+    float* const segment[2] = { channels[0] + start, channels[1] + start };
+    cascade.processStageMajor(segment, length, amount);
+  }
+}
+//==============================================================================
+// Returns the best time per sample in nanoseconds over all repetitions.
+template<typename Process>
+static double measure(Process process,
+                      Cascade& cascade,
+                      std::vector<float>& left,
+                      std::vector<float>& right,
+                      int blockSize,
+                      size_t amount)
+{
+  double best = 1.0e30;
+  for (int repetition = 0; repetition < REPETITIONS; ++repetition) {
+    cascade.reset();
+    const auto start = Clock::now();
+    for (int offset = 0; offset + blockSize <= SAMPLES_PER_RUN;
+         offset += blockSize) {
+      float* const channels[2] = { left.data() + offset,
+                                   right.data() + offset };
+      process(cascade, channels, blockSize, amount);
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+      Clock::now() - start;
+    best = std::min(best, elapsed.count() / SAMPLES_PER_RUN);
+  }
+  return best;
+}
+//==============================================================================
+int main()
+{
+  juce::ScopedNoDenormals noDenormals;
+
+  std::mt19937 generator(420);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  std::vector<float> input(SAMPLES_PER_RUN);
+  for (auto& sample : input)
+    sample = distribution(generator);
+
+  auto cascade = std::make_unique<Cascade>();
+  std::vector<float> left(input), right(input);
+
+  std::printf("%8s %8s %14s %14s %8s\n",
+              "amount",
+              "block",
+              "sample ns/smp",
+              "stage ns/smp",
+              "speedup");
+  for (const auto amount : AMOUNTS) {
+    setAllpassCoefficients(*cascade, amount);
+    for (const auto blockSize : BLOCK_SIZES) {
+      left = input;
+      right = input;
+      const double sampleMajor =
+        measure(processSampleMajor, *cascade, left, right, blockSize, amount);
+      left = input;
+      right = input;
+      const double stageMajor =
+        measure(processStageMajor, *cascade, left, right, blockSize, amount);
+      std::printf("%8zu %8d %14.3f %14.3f %7.2fx\n",
+                  amount,
+                  blockSize,
+                  sampleMajor,
+                  stageMajor,
+                  sampleMajor / stageMajor);
+    }
+  }
+  return 0;
+}
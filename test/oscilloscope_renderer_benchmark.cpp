@@ -0,0 +1,144 @@
+//==============================================================================
+// Benchmark comparing the frame time of the oscilloscope renderers.
+//
+// Build it as a console app against juce_audio_basics and juce_graphics with
+// the repository root on the include path, for example:
+//   g++ -std=c++20 -O3 -I<repo> -I<juce-headers> \
+//     oscilloscope_renderer_benchmark.cpp
+// Any optimisation level below -O2 makes the numbers meaningless.
+//
+// Every frame draws the samples of one 60 fps frame into a software image the
+// size of a scope in a large editor, the same way the Oscilloscope does. The
+// full redraw rows draw a whole image of history, like after a zoom change.
+#include "dsp/data/RingAudioBuffer.h"
+#include "gui/widget/ColumnRenderer.h"
+#include "gui/widget/MinMaxRenderer.h"
+#include "gui/widget/PathStrokeRenderer.h"
+#include "gui/widget/SimplifyingRenderer.h"
+#include <JuceHeader.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+//==============================================================================
+constexpr int IMAGE_WIDTH = 1800;
+constexpr int IMAGE_HEIGHT = 600;
+constexpr int SAMPLES_PER_FRAME = 800;
+constexpr int RING_SIZE = 1 << 20;
+constexpr int FRAMES = 200;
+constexpr int REPETITIONS = 5;
+constexpr float SAMPLES_PER_PIXEL[] = { 0.1f, 0.5f, 2.0f, 8.0f, 32.0f, 128.0f };
+constexpr float THICKNESS = 3.0f;
+
+using RingBuffer = dmt::dsp::data::RingAudioBuffer<float>;
+using Renderer = dmt::gui::widget::OscilloscopeRenderer<float>;
+using Clock = std::chrono::steady_clock;
+//==============================================================================
+// Returns the best time per frame in microseconds over all repetitions.
+template<typename RendererType>
+static double measure(RingBuffer& ringBuffer,
+                      juce::Image& image,
+                      float samplesPerPixel,
+                      int samplesPerFrame)
+{
+  const int maxSamples = (int)(samplesPerPixel * (float)IMAGE_WIDTH);
+  const int frameSamples = std::min(samplesPerFrame, maxSamples);
+  const float frameWidth = (float)frameSamples / samplesPerPixel;
+
+  double best = 1.0e30;
+  for (int repetition = 0; repetition < REPETITIONS; ++repetition) {
+    RendererType renderer;
+    image.clear(image.getBounds());
+    float x = 0.0f;
+    int start = 0;
+    const auto begin = Clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame) {
+      if (x + frameWidth > (float)IMAGE_WIDTH)
+        x = 0.0f;
+      juce::Graphics graphics(image);
+      const Renderer::RenderContext context{ start,
+                                             frameSamples,
+                                             x,
+                                             1.0f / samplesPerPixel,
+                                             IMAGE_HEIGHT / 2,
+                                             1.0f,
+                                             THICKNESS,
+                                             1.0f,
+                                             &image };
+      renderer.draw(graphics, ringBuffer, 0, context);
+      x += frameWidth;
+      start = (start + frameSamples) % RING_SIZE;
+    }
+    const std::chrono::duration<double, std::micro> elapsed =
+      Clock::now() - begin;
+    best = std::min(best, elapsed.count() / FRAMES);
+  }
+  return best;
+}
+//==============================================================================
+template<typename Measure>
+static void printRow(const char* name, float samplesPerPixel, Measure measure)
+{
+  const double path =
+    measure.template operator()<dmt::gui::widget::PathStrokeRenderer<float>>();
+  const double simplified =
+    measure.template operator()<dmt::gui::widget::SimplifyingRenderer<float>>();
+  const double minMax =
+    measure.template operator()<dmt::gui::widget::MinMaxRenderer<float>>();
+  const double column =
+    measure.template operator()<dmt::gui::widget::ColumnRenderer<float>>();
+  std::printf("%8s %8.1f %12.1f %12.1f %12.1f %12.1f %8.2fx\n",
+              name,
+              samplesPerPixel,
+              path,
+              simplified,
+              minMax,
+              column,
+              minMax / column);
+}
+//==============================================================================
+int main()
+{
+  std::mt19937 generator(420);
+  std::uniform_real_distribution<float> noise(-0.1f, 0.1f);
+
+  RingBuffer ringBuffer(1, RING_SIZE);
+  juce::AudioBuffer<float> input(1, RING_SIZE);
+  for (int sample = 0; sample < RING_SIZE; ++sample)
+    input.setSample(
+      0, sample, 0.8f * std::sin((float)sample * 0.01f) + noise(generator));
+
+  // A write takes at most the guard band, so the ring is filled in steps
+  const int guardSize = RingBuffer::getGuardSize(RING_SIZE);
+  for (int start = 0; start < RING_SIZE; start += guardSize) {
+    const juce::AudioBuffer<float> chunk(
+      input.getArrayOfWritePointers(), 1, start, guardSize);
+    ringBuffer.write(chunk);
+  }
+
+  juce::Image image(juce::Image::SingleChannel,
+                    IMAGE_WIDTH,
+                    IMAGE_HEIGHT,
+                    true,
+                    juce::SoftwareImageType{});
+
+  std::printf("%8s %8s %12s %12s %12s %12s %8s\n",
+              "frame",
+              "smp/px",
+              "path us",
+              "rdp us",
+              "minmax us",
+              "column us",
+              "speedup");
+  for (const auto samplesPerPixel : SAMPLES_PER_PIXEL) {
+    printRow("60 fps", samplesPerPixel, [&]<typename RendererType>() {
+      return measure<RendererType>(
+        ringBuffer, image, samplesPerPixel, SAMPLES_PER_FRAME);
+    });
+    printRow("full", samplesPerPixel, [&]<typename RendererType>() {
+      return measure<RendererType>(
+        ringBuffer, image, samplesPerPixel, RING_SIZE);
+    });
+  }
+  return 0;
+}
@@ -0,0 +1,106 @@
+//==============================================================================
+// Test rendering the UnisonOscillator over the oscillators the synth voices
+// use.
+//
+// Build it as a console app against juce_audio_basics with the repository
+// root on the include path, for example:
+//   g++ -std=c++20 -O2 -I<repo> -I<juce-headers> unison_oscillator_test.cpp
+// It prints every failed check and returns non-zero if there was one.
+//
+// A single voice has to play the wrapped oscillator unchanged in the center,
+// a wide stack has to differ between the channels, and two stacks with the
+// same seed have to render the same samples.
+#include "dsp/synth/AnalogOscillator.h"
+#include "dsp/synth/DigitalOscillator.h"
+#include "dsp/synth/UnisonOscillator.h"
+#include <JuceHeader.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+//==============================================================================
+constexpr float SAMPLE_RATE = 48000.0f;
+constexpr float FREQUENCY = 220.0f;
+constexpr int NUM_SAMPLES = 4096;
+
+static int failures = 0;
+//==============================================================================
+static void check(const bool condition, const char* type, const char* what)
+{
+  if (condition)
+    return;
+  std::printf("FAILED %s: %s\n", type, what);
+  ++failures;
+}
+//==============================================================================
+template<typename OscillatorType>
+struct Render
+{
+  std::vector<float> left = std::vector<float>(NUM_SAMPLES);
+  std::vector<float> right = std::vector<float>(NUM_SAMPLES);
+};
+//==============================================================================
+template<typename OscillatorType>
+static Render<OscillatorType> render(
+  const typename dmt::dsp::synth::UnisonOscillator<OscillatorType>::Parameters&
+    parameters)
+{
+  dmt::dsp::synth::UnisonOscillator<OscillatorType> osc;
+  osc.setSampleRate(SAMPLE_RATE);
+  osc.setParameters(parameters);
+  osc.reset();
+
+  const std::vector<float> frequencies(NUM_SAMPLES, FREQUENCY);
+  Render<OscillatorType> result;
+  osc.renderBlock(
+    result.left.data(), result.right.data(), frequencies.data(), NUM_SAMPLES);
+  return result;
+}
+//==============================================================================
+template<typename OscillatorType>
+static void test(const char* type)
+{
+  using Unison = dmt::dsp::synth::UnisonOscillator<OscillatorType>;
+
+  typename Unison::Parameters single;
+  const auto mono = render<OscillatorType>(single);
+  bool finite = true;
+  bool centered = true;
+  float peak = 0.0f;
+  for (int i = 0; i < NUM_SAMPLES; ++i) {
+    finite &= std::isfinite(mono.left[i]) && std::isfinite(mono.right[i]);
+    centered &= mono.left[i] == mono.right[i];
+    peak = std::max(peak, std::abs(mono.left[i]));
+  }
+  check(finite, type, "a single voice renders finite samples");
+  check(centered, type, "a single voice plays in the center");
+  check(peak > 0.1f, type, "a single voice is audible");
+
+  typename Unison::Parameters stack;
+  stack.density = 7;
+  stack.detune = 30.0f;
+  stack.width = 100.0f;
+  stack.seed = 42;
+  const auto first = render<OscillatorType>(stack);
+  const auto second = render<OscillatorType>(stack);
+  bool wide = false;
+  finite = true;
+  for (int i = 0; i < NUM_SAMPLES; ++i) {
+    finite &= std::isfinite(first.left[i]) && std::isfinite(first.right[i]);
+    wide |= std::abs(first.left[i] - first.right[i]) > 1e-3f;
+  }
+  check(finite, type, "a stack renders finite samples");
+  check(wide, type, "a wide stack differs between the channels");
+  check(first.left == second.left && first.right == second.right,
+        type,
+        "stacks with the same seed render the same samples");
+}
+//==============================================================================
+int main()
+{
+  test<dmt::dsp::synth::AnalogOscillator>("AnalogOscillator");
+  test<dmt::dsp::synth::DigitalOscillator>("DigitalOscillator");
+
+  if (failures == 0)
+    std::printf("All checks passed\n");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+//==============================================================================
+/* ██████╗ ██╗███╗   ███╗███████╗████████╗██╗  ██╗ ██████╗ ██╗  ██╗██╗   ██╗
+ * ██╔══██╗██║████╗ ████║██╔════╝╚══██╔══╝██║  ██║██╔═══██╗╚██╗██╔╝╚██╗ ██╔╝
+ * ██║  ██║██║██╔████╔██║█████╗     ██║   ███████║██║   ██║ ╚███╔╝  ╚████╔╝
+ * ██║  ██║██║██║╚██╔╝██║██╔══╝     ██║   ██╔══██║██║   ██║ ██╔██╗   ╚██╔╝
+ * ██████╔╝██║██║ ╚═╝ ██║███████╗   ██║   ██║  ██║╚██████╔╝██╔╝ ██╗   ██║
+ * ╚═════╝ ╚═╝╚═╝     ╚═╝╚══════╝   ╚═╝   ╚═╝  ╚═╝ ╚═════╝ ╚═╝  ╚═╝   ╚═╝
+ * Copyright (C) 2024 Dimethoxy Audio (https://dimethoxy.com)
+ *
+ * Part of the Dimethoxy Library, primarily intended for Dimethoxy plugins.
+ * External use is permitted but not recommended.
+ * No support or compatibility guarantees are provided.
+ *
+ * License:
+ * This code is licensed under the GPLv3 license. You are permitted to use and
+ * modify this code under the terms of this license.
+ * You must adhere GPLv3 license for any project using this code or parts of it.
+ * Your are not allowed to use this code in any closed-source project.
+ *
+ * Description:
+ * Branch-free float approximations of common math functions for batch
+ * coefficient calculations and per-sample processing. Written as plain scalar
+ * code so that loops calling them can be auto-vectorized by the compiler.
+ *
+ * Authors:
+ * Lunix-420 (Primary Author)
+ */
+//==============================================================================
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+//==============================================================================
+
+namespace dmt {
+namespace math {
+
+//==============================================================================
+
+/**
+ * @brief Approximates e^x for single precision floats.
+ *
+ * @param x The exponent. Must be within [-87, 88].
+ * @return An approximation of e^x.
+ *
+ * @details
+ * Writes x as n * ln(2) + r with integer n and |r| <= ln(2) / 2. The
+ * remainder goes through a polynomial for e^r, and n is written straight into
+ * the exponent bits of the result.
+ *
+ * @note The relative error stays below 1e-7 over the whole input range.
+ *       There is no clamping, so callers must keep x in range themselves,
+ *       for example with branchlessClamp().
+ */
+[[nodiscard]] forcedinline float
+fastExp(const float x) noexcept
+{
+  constexpr float log2e = 1.44269504088896341f;
+
+  // Within the valid range x / ln(2) + 128.5 is positive, so truncating rounds
+  const int integer = static_cast<int>(x * log2e + 128.5f) - 128;
+
+  // Subtract integer * ln(2) in two parts to keep the remainder exact
+  const float n = static_cast<float>(integer);
+  const float r = (x - n * 0.693359375f) + n * 2.12194440e-4f;
+
+  // Polynomial for e^r on [-ln(2) / 2, ln(2) / 2], coefficients from Cephes
+  float p = 1.9875691500e-4f;
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  p = p * r * r + r + 1.0f;
+
+  const auto scale =
+    std::bit_cast<float>(static_cast<std::int32_t>((integer + 127) << 23));
+  return p * scale;
+}
+
+//==============================================================================
+
+/**
+ * @brief Approximates tan(x) for x in [0, pi / 2).
+ *
+ * @param x The angle in radians. Must be in [0, pi / 2).
+ * @return An approximation of tan(x).
+ *
+ * @details
+ * Evaluates a [7/6] Padé approximant at x / 2, where it is accurate to well
+ * below float precision, and then applies the double angle formula
+ * tan(x) = 2t / (1 - t^2). This avoids the error growth the approximant has
+ * close to pi / 2 when it is evaluated there directly.
+ *
+ * @note The relative error is below 1e-6 for x up to 0.4 * pi and below
+ *       5e-6 up to 0.49 * pi. It keeps growing towards pi / 2 as 1 - t^2
+ *       loses precision.
+ */
+[[nodiscard]] forcedinline float
+fastTan(const float x) noexcept
+{
+  const float t = 0.5f * x;
+  const float t2 = t * t;
+  const float numerator =
+    t * (135135.0f + t2 * (-17325.0f + t2 * (378.0f - t2)));
+  const float denominator =
+    135135.0f + t2 * (-62370.0f + t2 * (3150.0f - 28.0f * t2));
+  const float halfTan = numerator / denominator;
+  return (2.0f * halfTan) / (1.0f - halfTan * halfTan);
+}
+
+//==============================================================================
+
+/**
+ * @brief Picks one of two floats without branching.
+ *
+ * @param condition Which value to pick.
+ * @param a The value returned when condition is true.
+ * @param b The value returned when condition is false.
+ * @return a or b.
+ *
+ * @details
+ * Both values are always computed, and the condition is turned into a bit
+ * mask. GCC treats the comparisons of a ternary or of std::clamp as control
+ * flow that may trap, and it also folds a float multiplied by a converted bool
+ * back into such a ternary. Either keeps it from vectorizing the calling loop
+ * unless trapping math is disabled, while a bit mask does not.
+ */
+[[nodiscard]] forcedinline float
+branchlessSelect(const bool condition, const float a, const float b) noexcept
+{
+  const auto mask = -static_cast<std::int32_t>(condition);
+  return std::bit_cast<float>((std::bit_cast<std::int32_t>(a) & mask) |
+                              (std::bit_cast<std::int32_t>(b) & ~mask));
+}
+
+//==============================================================================
+
+/**
+ * @brief Clamps a value without branching.
+ *
+ * @param x The value to clamp.
+ * @param lo The lower bound.
+ * @param hi The upper bound.
+ * @return x limited to [lo, hi].
+ */
+[[nodiscard]] forcedinline float
+branchlessClamp(const float x, const float lo, const float hi) noexcept
+{
+  return branchlessSelect(x < lo, lo, branchlessSelect(x > hi, hi, x));
+}
+
+//==============================================================================
+
+/**
+ * @brief Copies the sign of one float onto the magnitude of another.
+ *
+ * @param magnitude A non-negative value.
+ * @param sign The value whose sign bit is used.
+ * @return magnitude with the sign of sign.
+ */
+[[nodiscard]] forcedinline float
+withSignOf(const float magnitude, const float sign) noexcept
+{
+  const auto signBit = std::bit_cast<std::int32_t>(sign) &
+                       static_cast<std::int32_t>(0x80000000u);
+  return std::bit_cast<float>(std::bit_cast<std::int32_t>(magnitude) | signBit);
+}
+
+//==============================================================================
+
+/**
+ * @brief Approximates the natural logarithm for single precision floats.
+ *
+ * @param x The argument. Must be positive and normal.
+ * @return An approximation of ln(x).
+ *
+ * @details
+ * Splits x into 2^e * m with m in [sqrt(1/2), sqrt(2)) using integer maths
+ * on its bits, and evaluates a polynomial for ln(m). The coefficients are
+ * the ones of Cephes logf.
+ *
+ * @note The absolute error stays below 2e-7.
+ */
+[[nodiscard]] forcedinline float
+fastLog(const float x) noexcept
+{
+  // Subtracting the bits of sqrt(1/2) moves the exponent boundary there
+  const auto bits = std::bit_cast<std::int32_t>(x);
+  const std::int32_t exponent = (bits - 0x3f3504f3) >> 23;
+  const float m = std::bit_cast<float>(bits - (exponent << 23));
+  const float e = static_cast<float>(exponent);
+
+  const float f = m - 1.0f;
+  const float z = f * f;
+  float p = 7.0376836292e-2f;
+  p = p * f - 1.1514610310e-1f;
+  p = p * f + 1.1676998740e-1f;
+  p = p * f - 1.2420140846e-1f;
+  p = p * f + 1.4249322787e-1f;
+  p = p * f - 1.6668057665e-1f;
+  p = p * f + 2.0000714765e-1f;
+  p = p * f - 2.4999993993e-1f;
+  p = p * f + 3.3333331174e-1f;
+
+  // Add e * ln(2) in two parts, like the reduction in fastExp()
+  const float y = f * z * p - 2.12194440e-4f * e - 0.5f * z;
+  return f + y + 0.693359375f * e;
+}
+
+//==============================================================================
+
+/**
+ * @brief Approximates x^y for positive x.
+ *
+ * @param x The base. Must be positive and normal.
+ * @param y The exponent. Must be finite.
+ * @return An approximation of x^y.
+ *
+ * @details
+ * Computes e^(y ln(x)). The product is clamped to the range fastExp()
+ * accepts, so results that would underflow come out as about 1e-38 instead
+ * of zero.
+ */
+[[nodiscard]] forcedinline float
+fastPow(const float x, const float y) noexcept
+{
+  return fastExp(branchlessClamp(y * fastLog(x), -87.0f, 88.0f));
+}
+
+//==============================================================================
+
+/**
+ * @brief Approximates atan(x) for single precision floats.
+ *
+ * @param x The argument. Must be finite.
+ * @return An approximation of atan(x).
+ *
+ * @details
+ * Reduces |x| to [0, tan(pi / 8)] with the identities the Cephes atanf
+ * uses, selecting between the three cases instead of branching, and
+ * evaluates its polynomial there.
+ *
+ * @note The absolute error stays below 2e-7.
+ */
+[[nodiscard]] forcedinline float
+fastAtan(const float x) noexcept
+{
+  constexpr float tan3PiOver8 = 2.414213562373095f;
+  constexpr float tanPiOver8 = 0.4142135623730950f;
+  constexpr float pi = juce::MathConstants<float>::pi;
+
+  // Both reductions are computed for every input, so keep them finite
+  const float a = std::abs(x);
+  const float inverse = -1.0f / (a + 1.0e-30f);
+  const float shifted = (a - 1.0f) / (a + 1.0f);
+  const bool large = a > tan3PiOver8;
+  const bool medium = a > tanPiOver8;
+
+  const float z = branchlessSelect(
+    large, inverse, branchlessSelect(medium, shifted, a));
+  const float offset = branchlessSelect(
+    large, 0.5f * pi, branchlessSelect(medium, 0.25f * pi, 0.0f));
+
+  const float z2 = z * z;
+  float p = 8.05374449538e-2f;
+  p = p * z2 - 1.38776856032e-1f;
+  p = p * z2 + 1.99777106478e-1f;
+  p = p * z2 - 3.33329491539e-1f;
+  return withSignOf(offset + z + z * z2 * p, x);
+}
+
+//==============================================================================
+
+/**
+ * @brief Approximates sin(x) for single precision floats.
+ *
+ * @param x The angle in radians. Must be within [-1000 pi, 1000 pi].
+ * @return An approximation of sin(x).
+ *
+ * @details
+ * Writes x as k * pi + r with integer k and |r| <= pi / 2, evaluates the
+ * Taylor series of sin(r) up to r^11, which is accurate to float precision
+ * on that range, and flips the sign for odd k.
+ *
+ * @note The absolute error stays below 2e-7 plus the rounding error of
+ *       x itself, which grows with |x|.
+ */
+[[nodiscard]] forcedinline float
+fastSin(const float x) noexcept
+{
+  constexpr float invPi = 0.318309886183790672f;
+
+  // Within the valid range x / pi + 1024.5 is positive, so truncating rounds
+  const int k = static_cast<int>(x * invPi + 1024.5f) - 1024;
+
+  // Subtract k * pi in three parts to keep the remainder exact
+  const float n = static_cast<float>(k);
+  float r = x - n * 3.140625f;
+  r = r - n * 9.67502593994140625e-4f;
+  r = r - n * 1.509957990978376432e-7f;
+
+  const float r2 = r * r;
+  float p = 2.5052108385441718e-8f;
+  p = p * r2 - 2.7557319223985891e-6f;
+  p = p * r2 + 1.9841269841269841e-4f;
+  p = p * r2 - 8.3333333333333333e-3f;
+  p = p * r2 + 1.6666666666666667e-1f;
+  const float sine = r - r * r2 * p;
+
+  // sin(r + k * pi) = (-1)^k * sin(r), so odd k flips the sign bit
+  return std::bit_cast<float>(std::bit_cast<std::int32_t>(sine) ^ (k << 31));
+}
+
+//==============================================================================
+
+/**
+ * @brief Approximates cos(x) for single precision floats.
+ *
+ * @param x The angle in radians. Must be within [-999 pi, 999 pi].
+ * @return An approximation of cos(x).
+ */
+[[nodiscard]] forcedinline float
+fastCos(const float x) noexcept
+{
+  return fastSin(x + juce::MathConstants<float>::halfPi);
+}
+
+//==============================================================================
+} // namespace math
+} // namespace dmt
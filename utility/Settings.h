@@ -735,7 +735,8 @@ public:
    * @brief Oscilloscope default parameter settings.
    *
    * @details
-   * Controls default zoom, gain, and thickness for oscilloscopes.
+   * Controls default zoom, gain, and thickness for oscilloscopes, and the
+   * colour their traces are tinted with.
    */
   struct Oscilloscope
   {
@@ -747,6 +748,9 @@ public:
       container.add<float>("Oscilloscope.DefaultGain", 0.0f);
     static inline auto& defaultThickness =
       container.add<float>("Oscilloscope.DefaultThickness", 3.0f);
+    // Colours
+    static inline auto& traceColour =
+      container.add<Colour>("Oscilloscope.TraceColour", juce::Colours::white);
   };
 
   //==============================================================================
@@ -29,6 +29,7 @@
 
 //==============================================================================
 
+#include "./FastMath.h"
 #include "./Fonts.h"
 #include "./Icon.h"
 #include "./Math.h"